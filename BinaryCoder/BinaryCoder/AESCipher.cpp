@@ -0,0 +1,325 @@
+//
+//  AESCipher.cpp
+//  BinaryCoder
+//
+
+#include "AESCipher.h"
+#include "CPUFeatures.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <wmmintrin.h>
+#define AES_HAVE_NI 1
+#define AES_NI_TARGET __attribute__((target("aes,sse2")))
+#endif
+
+namespace binary_coder {
+
+    namespace {
+
+        /* The S-box and the round tables are computed by the compiler from
+         * the field arithmetic of FIPS-197, like Spbox in spbox.cpp.
+         */
+        constexpr uint32_t xtime(uint32_t x)
+        {
+            return ((x << 1) ^ ((x & 0x80) ? 0x1b : 0)) & 0xff;
+        }
+
+        constexpr uint32_t gmul(uint32_t a, uint32_t b)
+        {
+            return b == 0 ? 0 : (((b & 1) ? a : 0) ^ gmul(xtime(a), b >> 1));
+        }
+
+        constexpr uint32_t gpow(uint32_t x, int n)
+        {
+            return n == 0 ? 1 : gmul((n & 1) ? x : 1, gpow(gmul(x, x), n >> 1));
+        }
+
+        /* Multiplicative inverse, 0 for 0 */
+        constexpr uint32_t ginv(uint32_t x)
+        {
+            return gpow(x, 254);
+        }
+
+        constexpr uint32_t rotl8(uint32_t x, int n)
+        {
+            return ((x << n) | (x >> (8 - n))) & 0xff;
+        }
+
+        constexpr uint32_t sub(uint32_t b)
+        {
+            return b ^ rotl8(b, 1) ^ rotl8(b, 2) ^ rotl8(b, 3) ^ rotl8(b, 4) ^ 0x63;
+        }
+
+        constexpr uint32_t sbox(int x)
+        {
+            return sub(ginv(x));
+        }
+
+        constexpr uint32_t inv_sbox(int y)
+        {
+            return ginv(rotl8(y, 1) ^ rotl8(y, 3) ^ rotl8(y, 6) ^ 0x05);
+        }
+
+        /* One column of MixColumns for S-box output s in row 0 */
+        constexpr uint32_t te(uint32_t s)
+        {
+            return (gmul(s, 2) << 24) | (s << 16) | (s << 8) | gmul(s, 3);
+        }
+
+        /* One column of InvMixColumns for inverse S-box output s in row 0 */
+        constexpr uint32_t td(uint32_t s)
+        {
+            return (gmul(s, 14) << 24) | (gmul(s, 9) << 16) | (gmul(s, 13) << 8) | gmul(s, 11);
+        }
+
+#define T4(f,i)     f(i), f(i+1), f(i+2), f(i+3)
+#define T16(f,i)    T4(f,i), T4(f,i+4), T4(f,i+8), T4(f,i+12)
+#define T64(f,i)    T16(f,i), T16(f,i+16), T16(f,i+32), T16(f,i+48)
+#define T256(f)     { T64(f,0), T64(f,64), T64(f,128), T64(f,192) }
+#define SBOX(i)     (uint8_t)sbox(i)
+#define INV_SBOX(i) (uint8_t)inv_sbox(i)
+#define TE(i)       te(sbox(i))
+#define TD(i)       td(inv_sbox(i))
+
+        constexpr uint8_t S[256] = T256(SBOX);
+        constexpr uint8_t Si[256] = T256(INV_SBOX);
+        /* Te[x] for row 0; rows 1 to 3 use it rotated right by 8, 16 and 24 bits */
+        constexpr uint32_t Te[256] = T256(TE);
+        constexpr uint32_t Td[256] = T256(TD);
+
+        static_assert(sbox(0) == 0x63 && sbox(0x53) == 0xed && inv_sbox(0x63) == 0,
+                      "AES S-box does not match FIPS-197");
+
+        inline uint32_t ror(uint32_t x, int n)
+        {
+            return (x >> n) | (x << (32 - n));
+        }
+
+        inline uint32_t load_be(const uint8_t* p)
+        {
+            return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+        }
+
+        inline void store_be(uint8_t* p, uint32_t x)
+        {
+            p[0] = (uint8_t)(x >> 24);
+            p[1] = (uint8_t)(x >> 16);
+            p[2] = (uint8_t)(x >> 8);
+            p[3] = (uint8_t)x;
+        }
+
+        void encrypt_portable(const uint32_t* rk, int rounds, uint8_t* block)
+        {
+            uint32_t s0 = load_be(block) ^ rk[0];
+            uint32_t s1 = load_be(block + 4) ^ rk[1];
+            uint32_t s2 = load_be(block + 8) ^ rk[2];
+            uint32_t s3 = load_be(block + 12) ^ rk[3];
+            for (int r = 1; r < rounds; r++) {
+                rk += 4;
+                uint32_t t0 = Te[s0 >> 24] ^ ror(Te[(s1 >> 16) & 0xff], 8) ^ ror(Te[(s2 >> 8) & 0xff], 16) ^ ror(Te[s3 & 0xff], 24) ^ rk[0];
+                uint32_t t1 = Te[s1 >> 24] ^ ror(Te[(s2 >> 16) & 0xff], 8) ^ ror(Te[(s3 >> 8) & 0xff], 16) ^ ror(Te[s0 & 0xff], 24) ^ rk[1];
+                uint32_t t2 = Te[s2 >> 24] ^ ror(Te[(s3 >> 16) & 0xff], 8) ^ ror(Te[(s0 >> 8) & 0xff], 16) ^ ror(Te[s1 & 0xff], 24) ^ rk[2];
+                uint32_t t3 = Te[s3 >> 24] ^ ror(Te[(s0 >> 16) & 0xff], 8) ^ ror(Te[(s1 >> 8) & 0xff], 16) ^ ror(Te[s2 & 0xff], 24) ^ rk[3];
+                s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+            }
+            rk += 4;
+            store_be(block, ((uint32_t)S[s0 >> 24] << 24 | (uint32_t)S[(s1 >> 16) & 0xff] << 16 | (uint32_t)S[(s2 >> 8) & 0xff] << 8 | S[s3 & 0xff]) ^ rk[0]);
+            store_be(block + 4, ((uint32_t)S[s1 >> 24] << 24 | (uint32_t)S[(s2 >> 16) & 0xff] << 16 | (uint32_t)S[(s3 >> 8) & 0xff] << 8 | S[s0 & 0xff]) ^ rk[1]);
+            store_be(block + 8, ((uint32_t)S[s2 >> 24] << 24 | (uint32_t)S[(s3 >> 16) & 0xff] << 16 | (uint32_t)S[(s0 >> 8) & 0xff] << 8 | S[s1 & 0xff]) ^ rk[2]);
+            store_be(block + 12, ((uint32_t)S[s3 >> 24] << 24 | (uint32_t)S[(s0 >> 16) & 0xff] << 16 | (uint32_t)S[(s1 >> 8) & 0xff] << 8 | S[s2 & 0xff]) ^ rk[3]);
+        }
+
+        void decrypt_portable(const uint32_t* rk, int rounds, uint8_t* block)
+        {
+            uint32_t s0 = load_be(block) ^ rk[0];
+            uint32_t s1 = load_be(block + 4) ^ rk[1];
+            uint32_t s2 = load_be(block + 8) ^ rk[2];
+            uint32_t s3 = load_be(block + 12) ^ rk[3];
+            for (int r = 1; r < rounds; r++) {
+                rk += 4;
+                uint32_t t0 = Td[s0 >> 24] ^ ror(Td[(s3 >> 16) & 0xff], 8) ^ ror(Td[(s2 >> 8) & 0xff], 16) ^ ror(Td[s1 & 0xff], 24) ^ rk[0];
+                uint32_t t1 = Td[s1 >> 24] ^ ror(Td[(s0 >> 16) & 0xff], 8) ^ ror(Td[(s3 >> 8) & 0xff], 16) ^ ror(Td[s2 & 0xff], 24) ^ rk[1];
+                uint32_t t2 = Td[s2 >> 24] ^ ror(Td[(s1 >> 16) & 0xff], 8) ^ ror(Td[(s0 >> 8) & 0xff], 16) ^ ror(Td[s3 & 0xff], 24) ^ rk[2];
+                uint32_t t3 = Td[s3 >> 24] ^ ror(Td[(s2 >> 16) & 0xff], 8) ^ ror(Td[(s1 >> 8) & 0xff], 16) ^ ror(Td[s0 & 0xff], 24) ^ rk[3];
+                s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+            }
+            rk += 4;
+            store_be(block, ((uint32_t)Si[s0 >> 24] << 24 | (uint32_t)Si[(s3 >> 16) & 0xff] << 16 | (uint32_t)Si[(s2 >> 8) & 0xff] << 8 | Si[s1 & 0xff]) ^ rk[0]);
+            store_be(block + 4, ((uint32_t)Si[s1 >> 24] << 24 | (uint32_t)Si[(s0 >> 16) & 0xff] << 16 | (uint32_t)Si[(s3 >> 8) & 0xff] << 8 | Si[s2 & 0xff]) ^ rk[1]);
+            store_be(block + 8, ((uint32_t)Si[s2 >> 24] << 24 | (uint32_t)Si[(s1 >> 16) & 0xff] << 16 | (uint32_t)Si[(s0 >> 8) & 0xff] << 8 | Si[s3 & 0xff]) ^ rk[2]);
+            store_be(block + 12, ((uint32_t)Si[s3 >> 24] << 24 | (uint32_t)Si[(s2 >> 16) & 0xff] << 16 | (uint32_t)Si[(s1 >> 8) & 0xff] << 8 | Si[s0 & 0xff]) ^ rk[3]);
+        }
+
+#ifdef AES_HAVE_NI
+        /* Blocks interleaved per loop, to keep the AES unit's pipeline busy */
+#define AES_NI_LANES 4
+
+        AES_NI_TARGET
+        void encrypt_ni(const uint8_t* keys, int rounds, uint8_t* data, size_t blocks)
+        {
+            __m128i rk[15];
+            for (int r = 0; r <= rounds; r++) {
+                rk[r] = _mm_loadu_si128((const __m128i*)(keys + 16*r));
+            }
+            for (; blocks >= AES_NI_LANES; blocks -= AES_NI_LANES, data += 16*AES_NI_LANES) {
+                __m128i b[AES_NI_LANES];
+                for (int i = 0; i < AES_NI_LANES; i++) {
+                    b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(data + 16*i)), rk[0]);
+                }
+                for (int r = 1; r < rounds; r++) {
+                    for (int i = 0; i < AES_NI_LANES; i++) {
+                        b[i] = _mm_aesenc_si128(b[i], rk[r]);
+                    }
+                }
+                for (int i = 0; i < AES_NI_LANES; i++) {
+                    _mm_storeu_si128((__m128i*)(data + 16*i), _mm_aesenclast_si128(b[i], rk[rounds]));
+                }
+            }
+            for (; blocks > 0; blocks--, data += 16) {
+                __m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i*)data), rk[0]);
+                for (int r = 1; r < rounds; r++) {
+                    b = _mm_aesenc_si128(b, rk[r]);
+                }
+                _mm_storeu_si128((__m128i*)data, _mm_aesenclast_si128(b, rk[rounds]));
+            }
+        }
+
+        AES_NI_TARGET
+        void decrypt_ni(const uint8_t* keys, int rounds, uint8_t* data, size_t blocks)
+        {
+            __m128i rk[15];
+            for (int r = 0; r <= rounds; r++) {
+                rk[r] = _mm_loadu_si128((const __m128i*)(keys + 16*r));
+            }
+            for (; blocks >= AES_NI_LANES; blocks -= AES_NI_LANES, data += 16*AES_NI_LANES) {
+                __m128i b[AES_NI_LANES];
+                for (int i = 0; i < AES_NI_LANES; i++) {
+                    b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(data + 16*i)), rk[0]);
+                }
+                for (int r = 1; r < rounds; r++) {
+                    for (int i = 0; i < AES_NI_LANES; i++) {
+                        b[i] = _mm_aesdec_si128(b[i], rk[r]);
+                    }
+                }
+                for (int i = 0; i < AES_NI_LANES; i++) {
+                    _mm_storeu_si128((__m128i*)(data + 16*i), _mm_aesdeclast_si128(b[i], rk[rounds]));
+                }
+            }
+            for (; blocks > 0; blocks--, data += 16) {
+                __m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i*)data), rk[0]);
+                for (int r = 1; r < rounds; r++) {
+                    b = _mm_aesdec_si128(b, rk[r]);
+                }
+                _mm_storeu_si128((__m128i*)data, _mm_aesdeclast_si128(b, rk[rounds]));
+            }
+        }
+#endif
+
+    } /* namespace */
+
+    AESCipher::AESCipher()
+    {
+        rounds_ = 0;
+        hardware_ = HardwareSupported();
+    }
+
+    AESCipher::AESCipher(const uint8_t* key, size_t key_bytes)
+    {
+        rounds_ = 0;
+        hardware_ = HardwareSupported();
+        SetKey(key, key_bytes);
+    }
+
+    bool AESCipher::HardwareSupported()
+    {
+#ifdef AES_HAVE_NI
+        return GetCPUFeatures().aesni;
+#else
+        return false;
+#endif
+    }
+
+    bool AESCipher::UseHardware(bool enable)
+    {
+        hardware_ = enable && HardwareSupported();
+        return hardware_;
+    }
+
+    bool AESCipher::SetKey(const uint8_t* key, size_t key_bytes)
+    {
+        if (key_bytes != 16 && key_bytes != 24 && key_bytes != 32) {
+            rounds_ = 0;
+            return false;
+        }
+        int nk = (int)(key_bytes >> 2);
+        rounds_ = nk + 6;
+        int words = 4 * (rounds_ + 1);
+
+        // Key expansion, FIPS-197 5.2.
+        uint32_t* w = encrypt_keys_;
+        for (int i = 0; i < nk; i++) {
+            w[i] = load_be(key + 4*i);
+        }
+        uint32_t rcon = 1;
+        for (int i = nk; i < words; i++) {
+            uint32_t t = w[i - 1];
+            if (i % nk == 0) {
+                t = ((uint32_t)S[(t >> 16) & 0xff] << 24 | (uint32_t)S[(t >> 8) & 0xff] << 16 |
+                     (uint32_t)S[t & 0xff] << 8 | S[t >> 24]) ^ (rcon << 24);
+                rcon = xtime(rcon);
+            } else if (nk > 6 && i % nk == 4) {
+                t = (uint32_t)S[t >> 24] << 24 | (uint32_t)S[(t >> 16) & 0xff] << 16 |
+                    (uint32_t)S[(t >> 8) & 0xff] << 8 | S[t & 0xff];
+            }
+            w[i] = w[i - nk] ^ t;
+        }
+
+        // The equivalent inverse cipher takes the round keys backwards,
+        // with InvMixColumns applied to all but the first and the last.
+        for (int r = 0; r <= rounds_; r++) {
+            for (int j = 0; j < 4; j++) {
+                uint32_t k = encrypt_keys_[4*(rounds_ - r) + j];
+                if (r > 0 && r < rounds_) {
+                    k = Td[S[k >> 24]] ^ ror(Td[S[(k >> 16) & 0xff]], 8) ^
+                        ror(Td[S[(k >> 8) & 0xff]], 16) ^ ror(Td[S[k & 0xff]], 24);
+                }
+                decrypt_keys_[4*r + j] = k;
+            }
+        }
+
+        for (int i = 0; i < words; i++) {
+            store_be(encrypt_bytes_ + 4*i, encrypt_keys_[i]);
+            store_be(decrypt_bytes_ + 4*i, decrypt_keys_[i]);
+        }
+        return true;
+    }
+
+    void AESCipher::Encrypt(uint8_t* data, size_t blocks) const
+    {
+        assert(rounds_ > 0);
+#ifdef AES_HAVE_NI
+        if (hardware_) {
+            encrypt_ni(encrypt_bytes_, rounds_, data, blocks);
+            return;
+        }
+#endif
+        for (size_t i = 0; i < blocks; i++) {
+            encrypt_portable(encrypt_keys_, rounds_, data + 16*i);
+        }
+    }
+
+    void AESCipher::Decrypt(uint8_t* data, size_t blocks) const
+    {
+        assert(rounds_ > 0);
+#ifdef AES_HAVE_NI
+        if (hardware_) {
+            decrypt_ni(decrypt_bytes_, rounds_, data, blocks);
+            return;
+        }
+#endif
+        for (size_t i = 0; i < blocks; i++) {
+            decrypt_portable(decrypt_keys_, rounds_, data + 16*i);
+        }
+    }
+
+} /* binary_coder */
@@ -0,0 +1,57 @@
+//
+//  AESCipher.h
+//  BinaryCoder
+//
+
+#ifndef BINARYCODER_AESCIPHER_H_
+#define BINARYCODER_AESCIPHER_H_
+
+#include "BlockCipher.h"
+
+namespace binary_coder {
+
+    /**
+     * AES (FIPS-197) with 128, 192 or 256 bits keys behind the BlockCipher
+     * interface. It runs on the AES-NI instructions when the CPU has them
+     * and on a portable table implementation otherwise; both give the
+     * same output.
+     */
+    class AESCipher: public BlockCipher
+    {
+    public:
+        AESCipher();
+        /* key          key_bytes bytes of key
+          key_bytes     16, 24 or 32
+         */
+        AESCipher(const uint8_t* key, size_t key_bytes);
+
+        /* Returns false, leaving the cipher unkeyed, if key_bytes is not 16, 24 or 32. */
+        bool SetKey(const uint8_t* key, size_t key_bytes);
+
+        /* Whether the CPU has the AES-NI instructions. */
+        static bool HardwareSupported();
+        /* Choose between AES-NI (when supported) and the portable code, for
+          testing and benchmarks. Returns whether AES-NI is used. */
+        bool UseHardware(bool enable);
+
+        virtual size_t BlockSize() const { return 16; }
+        virtual size_t BatchBlocks() const { return 8; }
+        virtual void Encrypt(uint8_t* data, size_t blocks) const;
+        virtual void Decrypt(uint8_t* data, size_t blocks) const;
+
+    private:
+        /** 10, 12 or 14; 0 while unkeyed. */
+        int rounds_;
+        bool hardware_;
+        /** Round keys as big-endian words, for the portable code. */
+        uint32_t encrypt_keys_[60];
+        /** Round keys of the equivalent inverse cipher (FIPS-197 5.3.5). */
+        uint32_t decrypt_keys_[60];
+        /** The same round keys as bytes, for AES-NI. */
+        uint8_t encrypt_bytes_[240];
+        uint8_t decrypt_bytes_[240];
+    };
+
+} /* binary_coder */
+
+#endif /* defined(BINARYCODER_AESCIPHER_H_) */
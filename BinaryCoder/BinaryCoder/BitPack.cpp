@@ -0,0 +1,133 @@
+//
+//  BitPack.cpp
+//  BinaryCoder
+//
+
+#include "BitPack.h"
+#include "CPUFeatures.h"
+#include "ByteOrder.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define PACK_HAVE_X86 1
+#define PACK_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace binary_coder {
+
+    namespace {
+
+        /* One 8-byte load per field while 8 bytes are left, byte loads for
+         * the last few fields.
+         */
+        void unpack_portable(const uint8_t* data, int bit_offset, int bits, uint32_t* values, size_t count)
+        {
+            size_t end = ((size_t)bit_offset + count * bits + 7) >> 3;
+            size_t pos = bit_offset;
+            for (size_t i = 0; i < count; i++, pos += bits) {
+                size_t at = pos >> 3;
+                uint64_t window;
+                if (at + 8 <= end) {
+                    window = BigEndian::Load64(data + at);
+                } else {
+                    window = 0;
+                    for (size_t j = 0; at + j < end; j++) {
+                        window |= (uint64_t)data[at + j] << (56 - 8 * j);
+                    }
+                }
+                values[i] = (uint32_t)((window << (pos & 7)) >> (64 - bits));
+            }
+        }
+
+#ifdef PACK_HAVE_X86
+        /* 8 fields of b bits take exactly b bytes, so every group starts
+         * at the same bit offset and one set of shuffle masks serves the
+         * whole array. Each 128-bit half gathers the 4 bytes under each of
+         * its 4 fields, most significant first, from its own 16-byte load:
+         * fields 0-3 from the group start, fields 4-7 from the byte holding
+         * field 4. A per-lane left shift drops the leading bits and a right
+         * shift the trailing ones; a field of up to 25 bits plus its 7-bit
+         * offset fits in the 4 bytes.
+         */
+        PACK_AVX2_TARGET
+        void unpack_avx2(const uint8_t* data, int bit_offset, int bits, uint32_t* values, size_t count)
+        {
+            if (bits > 25 || count < 8) {
+                unpack_portable(data, bit_offset, bits, values, count);
+                return;
+            }
+
+            uint8_t mask[32];
+            uint32_t shift[8];
+            int high = (bit_offset + 4 * bits) >> 3;
+            for (int i = 0; i < 8; i++) {
+                int start = bit_offset + i * bits;
+                int rel = (start >> 3) - (i < 4 ? 0 : high);
+                for (int k = 0; k < 4; k++) {
+                    mask[i * 4 + 3 - k] = (uint8_t)(rel + k);
+                }
+                shift[i] = start & 7;
+            }
+            const __m256i shuffle = _mm256_loadu_si256((const __m256i*)mask);
+            const __m256i left = _mm256_loadu_si256((const __m256i*)shift);
+            const __m128i right = _mm_cvtsi32_si128(32 - bits);
+
+            // Both 16-byte loads of a group stay within the fields' bytes.
+            size_t end = ((size_t)bit_offset + count * bits + 7) >> 3;
+            size_t groups = count >> 3;
+            const uint8_t* p = data;
+            size_t g = 0;
+            for (; g < groups && (size_t)(p - data) + high + 16 <= end; g++) {
+                __m256i x = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+                    _mm_loadu_si128((const __m128i*)(p + high)), 1);
+                x = _mm256_shuffle_epi8(x, shuffle);
+                x = _mm256_srl_epi32(_mm256_sllv_epi32(x, left), right);
+                _mm256_storeu_si256((__m256i*)(values + (g << 3)), x);
+                p += bits;
+            }
+            unpack_portable(p, bit_offset, bits, values + (g << 3), count - (g << 3));
+        }
+#endif
+
+        typedef void (*unpack_fn)(const uint8_t*, int, int, uint32_t*, size_t);
+
+        unpack_fn SelectUnpack()
+        {
+#ifdef PACK_HAVE_X86
+            if (GetCPUFeatures().avx2) {
+                return unpack_avx2;
+            }
+#endif
+            return unpack_portable;
+        }
+
+    } /* namespace */
+
+    void UnpackBits(const uint8_t* data, int bit_offset, int bits, uint32_t* values, size_t count)
+    {
+        static const unpack_fn kernel = SelectUnpack();
+        kernel(data, bit_offset, bits, values, count);
+    }
+
+    void UnpackBitsLSB(const uint8_t* data, int bit_offset, int bits, uint32_t* values, size_t count)
+    {
+        size_t end = ((size_t)bit_offset + count * bits + 7) >> 3;
+        size_t pos = bit_offset;
+        uint64_t mask = ~(uint64_t)0 >> (64 - bits);
+        for (size_t i = 0; i < count; i++, pos += bits) {
+            size_t at = pos >> 3;
+            uint64_t window;
+            if (at + 8 <= end) {
+                window = LittleEndian::Load64(data + at);
+            } else {
+                window = 0;
+                for (size_t j = 0; at + j < end; j++) {
+                    window |= (uint64_t)data[at + j] << (8 * j);
+                }
+            }
+            values[i] = (uint32_t)((window >> (pos & 7)) & mask);
+        }
+    }
+
+} /* binary_coder */
@@ -0,0 +1,38 @@
+//
+//  BitPack.h
+//  BinaryCoder
+//
+
+#ifndef BINARYCODER_BITPACK_H_
+#define BINARYCODER_BITPACK_H_
+
+#include "STDHeaders.h"
+
+namespace binary_coder {
+
+    /**
+     * Unpack count fields of bits bits each (1 to 32), stored back to back
+     * with the most significant bit first, as Encoder::WriteBits() writes
+     * them. Uses AVX2 shuffles and shifts, 8 fields at a time, for fields
+     * of up to 25 bits when the CPU has them (see CPUFeatures.h).
+     * @param data
+     *          the byte holding the first bit.
+     * @param bit_offset
+     *          the number of bits (0 to 7) to skip in that byte.
+     * @param values
+     *          receives the count fields.
+     * Only the (bit_offset + count*bits + 7) / 8 bytes holding the fields
+     * are read.
+     */
+    void UnpackBits(const uint8_t* data, int bit_offset, int bits, uint32_t* values, size_t count);
+
+    /**
+     * UnpackBits() for fields stored least significant bit first, from
+     * the least significant bit of every byte up (see LSBFirst). One
+     * 8-byte load per field, no vector version.
+     */
+    void UnpackBitsLSB(const uint8_t* data, int bit_offset, int bits, uint32_t* values, size_t count);
+
+} /* binary_coder */
+
+#endif /* defined(BINARYCODER_BITPACK_H_) */
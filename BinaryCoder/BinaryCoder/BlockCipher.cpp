@@ -0,0 +1,93 @@
+//
+//  BlockCipher.cpp
+//  BinaryCoder
+//
+
+#include "BlockCipher.h"
+#include "WorkerPool.h"
+#include "DESKeyCache.h"
+
+namespace binary_coder {
+
+    void CipherECB(const BlockCipher& cipher, bool decrypt, uint8_t* data, size_t blocks,
+                   WorkerPool* pool, size_t threshold)
+    {
+        size_t block_size = cipher.BlockSize();
+        ParallelRanges(pool, blocks, cipher.BatchBlocks(), threshold / block_size, [&](size_t begin, size_t end) {
+            if (decrypt) {
+                cipher.Decrypt(data + begin * block_size, end - begin);
+            } else {
+                cipher.Encrypt(data + begin * block_size, end - begin);
+            }
+        });
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+
+    DESCipher::DESCipher()
+    {
+        memset(encrypt_ks_, 0, sizeof(encrypt_ks_));
+        memset(decrypt_ks_, 0, sizeof(decrypt_ks_));
+    }
+
+    DESCipher::DESCipher(const uint8_t key[8])
+    {
+        SetKey(key);
+    }
+
+    void DESCipher::SetKey(const uint8_t key[8])
+    {
+        DESKeyCache::Shared().Schedule(encrypt_ks_, key, 0);
+        DESKeyCache::Shared().Schedule(decrypt_ks_, key, 1);
+    }
+
+    size_t DESCipher::BatchBlocks() const
+    {
+        return desbs_width();
+    }
+
+    void DESCipher::Encrypt(uint8_t* data, size_t blocks) const
+    {
+        desecb((uint32_t (*)[2])encrypt_ks_, data, blocks);
+    }
+
+    void DESCipher::Decrypt(uint8_t* data, size_t blocks) const
+    {
+        desecb((uint32_t (*)[2])decrypt_ks_, data, blocks);
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+
+    DES3Cipher::DES3Cipher()
+    {
+        memset(encrypt_ks_, 0, sizeof(encrypt_ks_));
+        memset(decrypt_ks_, 0, sizeof(decrypt_ks_));
+    }
+
+    DES3Cipher::DES3Cipher(const uint8_t key[24])
+    {
+        SetKey(key);
+    }
+
+    void DES3Cipher::SetKey(const uint8_t key[24])
+    {
+        DESKeyCache::Shared().Schedule3(encrypt_ks_, key, 0);
+        DESKeyCache::Shared().Schedule3(decrypt_ks_, key, 1);
+    }
+
+    size_t DES3Cipher::BatchBlocks() const
+    {
+        return desbs_width();
+    }
+
+    void DES3Cipher::Encrypt(uint8_t* data, size_t blocks) const
+    {
+        des3ecb((uint32_t (*)[2])encrypt_ks_, data, blocks);
+    }
+
+    void DES3Cipher::Decrypt(uint8_t* data, size_t blocks) const
+    {
+        des3ecb((uint32_t (*)[2])decrypt_ks_, data, blocks);
+    }
+
+} /* binary_coder */
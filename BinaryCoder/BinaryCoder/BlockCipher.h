@@ -0,0 +1,97 @@
+//
+//  BlockCipher.h
+//  BinaryCoder
+//
+
+#ifndef BINARYCODER_BLOCKCIPHER_H_
+#define BINARYCODER_BLOCKCIPHER_H_
+
+#include "STDHeaders.h"
+#include "Constants.h"
+
+extern "C" {
+#include "des.h"
+}
+
+namespace binary_coder {
+
+    class WorkerPool;
+
+    /**
+     * A keyed block cipher working in place on whole blocks, as used by
+     * InputStreamCipher and OutputStreamCipher. Encrypt() and Decrypt()
+     * must not change the cipher, so one keyed instance can serve several
+     * streams and threads at once.
+     */
+    class BlockCipher
+    {
+    public:
+        virtual ~BlockCipher() {}
+
+        /** Size of a block in bytes, a power of two. */
+        virtual size_t BlockSize() const = 0;
+
+        /**
+         * Number of blocks the implementation likes to get in one call.
+         * Work split over a WorkerPool is cut in multiples of it.
+         */
+        virtual size_t BatchBlocks() const { return 1; }
+
+        virtual void Encrypt(uint8_t* data, size_t blocks) const = 0;
+        virtual void Decrypt(uint8_t* data, size_t blocks) const = 0;
+    };
+
+    /* Encrypt or decrypt blocks in place in ECB mode with any cipher.
+      The work is split over pool when data is at least threshold bytes,
+      otherwise it runs on the calling thread. pool may be NULL.
+     */
+    void CipherECB(const BlockCipher& cipher, bool decrypt, uint8_t* data, size_t blocks,
+                   WorkerPool* pool, size_t threshold);
+
+    /**
+     * DES behind the BlockCipher interface, on the bitsliced engine.
+     */
+    class DESCipher: public BlockCipher
+    {
+    public:
+        DESCipher();
+        /* key          64 bits key (only 56 bits used) */
+        explicit DESCipher(const uint8_t key[8]);
+
+        void SetKey(const uint8_t key[8]);
+
+        virtual size_t BlockSize() const { return 8; }
+        virtual size_t BatchBlocks() const;
+        virtual void Encrypt(uint8_t* data, size_t blocks) const;
+        virtual void Decrypt(uint8_t* data, size_t blocks) const;
+
+    private:
+        DES_KS encrypt_ks_;
+        DES_KS decrypt_ks_;
+    };
+
+    /**
+     * Triple DES (EDE3) behind the BlockCipher interface.
+     */
+    class DES3Cipher: public BlockCipher
+    {
+    public:
+        DES3Cipher();
+        /* key          K1, K2 and K3, 64 bits each (only 56 bits used) */
+        explicit DES3Cipher(const uint8_t key[24]);
+
+        void SetKey(const uint8_t key[24]);
+
+        virtual size_t BlockSize() const { return 8; }
+        virtual size_t BatchBlocks() const;
+        virtual void Encrypt(uint8_t* data, size_t blocks) const;
+        virtual void Decrypt(uint8_t* data, size_t blocks) const;
+
+    private:
+        DES3_KS encrypt_ks_;
+        DES3_KS decrypt_ks_;
+    };
+
+} /* binary_coder */
+
+#endif /* defined(BINARYCODER_BLOCKCIPHER_H_) */
@@ -0,0 +1,129 @@
+//
+//  ByteOrder.h
+//  BinaryCoder
+//
+
+#ifndef BINARYCODER_BYTEORDER_H_
+#define BINARYCODER_BYTEORDER_H_
+
+#include "STDHeaders.h"
+
+namespace binary_coder {
+
+    inline uint16_t ByteSwap16(uint16_t value)
+    {
+        return (uint16_t)((value >> 8) | (value << 8));
+    }
+
+    inline uint32_t ByteSwap32(uint32_t value)
+    {
+#if defined(__GNUC__)
+        return __builtin_bswap32(value);
+#else
+        return (value >> 24) | ((value >> 8) & 0xff00) | ((value << 8) & 0xff0000) | (value << 24);
+#endif
+    }
+
+    inline uint64_t ByteSwap64(uint64_t value)
+    {
+#if defined(__GNUC__)
+        return __builtin_bswap64(value);
+#else
+        return ((uint64_t)ByteSwap32((uint32_t)value) << 32) | ByteSwap32((uint32_t)(value >> 32));
+#endif
+    }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define BINARYCODER_LITTLE_ENDIAN_HOST false
+#else
+#define BINARYCODER_LITTLE_ENDIAN_HOST true
+#endif
+
+    /**
+     * Loads and stores in the host byte order (is_host) or the other one.
+     * Either way they are a memcpy, plus a byte swap in the second case.
+     */
+    template <bool is_host>
+    struct ByteOrderAccess
+    {
+        /** Whether arrays can be copied as they are. */
+        static const bool IsHost = is_host;
+        
+        static uint16_t Load16(const uint8_t* p) {
+            uint16_t value;
+            memcpy(&value, p, sizeof(value));
+            return is_host ? value : ByteSwap16(value);
+        }
+        static uint32_t Load32(const uint8_t* p) {
+            uint32_t value;
+            memcpy(&value, p, sizeof(value));
+            return is_host ? value : ByteSwap32(value);
+        }
+        static uint64_t Load64(const uint8_t* p) {
+            uint64_t value;
+            memcpy(&value, p, sizeof(value));
+            return is_host ? value : ByteSwap64(value);
+        }
+        static void Store16(uint8_t* p, uint16_t value) {
+            value = is_host ? value : ByteSwap16(value);
+            memcpy(p, &value, sizeof(value));
+        }
+        static void Store32(uint8_t* p, uint32_t value) {
+            value = is_host ? value : ByteSwap32(value);
+            memcpy(p, &value, sizeof(value));
+        }
+        static void Store64(uint8_t* p, uint64_t value) {
+            value = is_host ? value : ByteSwap64(value);
+            memcpy(p, &value, sizeof(value));
+        }
+    };
+
+    /**
+     * Byte orders of multi-byte integers, the ByteOrder parameter of
+     * BasicEncoder and BasicDecoder.
+     */
+    struct LittleEndian: ByteOrderAccess<BINARYCODER_LITTLE_ENDIAN_HOST> {};
+    struct BigEndian: ByteOrderAccess<!BINARYCODER_LITTLE_ENDIAN_HOST> {};
+
+    /**
+     * Bit orders of bit fields, the BitOrder parameter of BasicEncoder and
+     * BasicDecoder.
+     *
+     * MSBFirst fills every byte from its most significant bit down and
+     * writes a field's most significant bit first, as SWF and MPEG do.
+     * LSBFirst fills every byte from its least significant bit up and
+     * writes a field's least significant bit first, as DEFLATE does.
+     *
+     * Either way 8 bytes loaded in the matching byte order (big-endian for
+     * MSBFirst, little-endian for LSBFirst) hold the next fields in stream
+     * order, so both are read and written through a 64-bit register.
+     */
+    struct MSBFirst
+    {
+        typedef BigEndian WordOrder;
+        static const bool MostSignificantFirst = true;
+    };
+
+    struct LSBFirst
+    {
+        typedef LittleEndian WordOrder;
+        static const bool MostSignificantFirst = false;
+    };
+
+    /**
+     * Reverse the bytes of count values of size bytes each, in place.
+     */
+    inline void SwapBytes(uint8_t* p, size_t size, size_t count)
+    {
+        for (size_t i = 0; i < count; i++, p += size) {
+            for (size_t j = 0; j < size / 2; j++) {
+                uint8_t b = p[j];
+                p[j] = p[size - 1 - j];
+                p[size - 1 - j] = b;
+            }
+        }
+    }
+
+} /* binary_coder */
+
+#endif /* defined(BINARYCODER_BYTEORDER_H_) */
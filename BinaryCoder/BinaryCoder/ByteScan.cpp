@@ -0,0 +1,99 @@
+//
+//  ByteScan.cpp
+//  BinaryCoder
+//
+
+#include "ByteScan.h"
+#include "CPUFeatures.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define SCAN_HAVE_X86 1
+#define SCAN_SSE2_TARGET __attribute__((target("sse2")))
+#define SCAN_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace binary_coder {
+
+    namespace {
+
+        const uint8_t* find_portable(const uint8_t* p, size_t n, uint8_t value)
+        {
+            return (const uint8_t*)memchr(p, value, n);
+        }
+
+#ifdef SCAN_HAVE_X86
+        /* The vector loops never read past the end of the data: the tail
+         * shorter than a register goes through memchr().
+         */
+        SCAN_SSE2_TARGET
+        const uint8_t* find_sse2(const uint8_t* p, size_t n, uint8_t value)
+        {
+            const __m128i v = _mm_set1_epi8((char)value);
+            while (n >= 16) {
+                __m128i x = _mm_loadu_si128((const __m128i*)p);
+                int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(x, v));
+                if (mask != 0) {
+                    return p + __builtin_ctz((unsigned int)mask);
+                }
+                p += 16;
+                n -= 16;
+            }
+            return find_portable(p, n, value);
+        }
+
+        SCAN_AVX2_TARGET
+        const uint8_t* find_avx2(const uint8_t* p, size_t n, uint8_t value)
+        {
+            const __m256i v = _mm256_set1_epi8((char)value);
+            while (n >= 64) {
+                __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)p), v);
+                __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + 32)), v);
+                if (!_mm256_testz_si256(_mm256_or_si256(a, b), _mm256_or_si256(a, b))) {
+                    unsigned int ma = (unsigned int)_mm256_movemask_epi8(a);
+                    if (ma != 0) {
+                        return p + __builtin_ctz(ma);
+                    }
+                    return p + 32 + __builtin_ctz((unsigned int)_mm256_movemask_epi8(b));
+                }
+                p += 64;
+                n -= 64;
+            }
+            while (n >= 32) {
+                __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)p), v);
+                unsigned int ma = (unsigned int)_mm256_movemask_epi8(a);
+                if (ma != 0) {
+                    return p + __builtin_ctz(ma);
+                }
+                p += 32;
+                n -= 32;
+            }
+            return find_portable(p, n, value);
+        }
+#endif
+
+        typedef const uint8_t* (*find_fn)(const uint8_t*, size_t, uint8_t);
+
+        find_fn SelectFind()
+        {
+#ifdef SCAN_HAVE_X86
+            const CPUFeatures& cpu = GetCPUFeatures();
+            if (cpu.avx2) {
+                return find_avx2;
+            }
+            if (cpu.sse2) {
+                return find_sse2;
+            }
+#endif
+            return find_portable;
+        }
+
+    } /* namespace */
+
+    const uint8_t* FindByte(const uint8_t* data, size_t length, uint8_t value)
+    {
+        static const find_fn kernel = SelectFind();
+        return kernel(data, length, value);
+    }
+
+} /* binary_coder */
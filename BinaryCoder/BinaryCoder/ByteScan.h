@@ -0,0 +1,22 @@
+//
+//  ByteScan.h
+//  BinaryCoder
+//
+
+#ifndef BINARYCODER_BYTESCAN_H_
+#define BINARYCODER_BYTESCAN_H_
+
+#include "STDHeaders.h"
+
+namespace binary_coder {
+
+    /**
+     * Find the first byte equal to value among length bytes, like memchr().
+     * Uses AVX2 or SSE2 compares when the CPU has them (see CPUFeatures.h).
+     * @return a pointer to the byte, or NULL if there is none.
+     */
+    const uint8_t* FindByte(const uint8_t* data, size_t length, uint8_t value);
+
+} /* binary_coder */
+
+#endif /* defined(BINARYCODER_BYTESCAN_H_) */
@@ -0,0 +1,129 @@
+//
+//  CPUFeatures.cpp
+//  BinaryCoder
+//
+
+#include "CPUFeatures.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <cpuid.h>
+#define CPU_HAVE_CPUID 1
+#endif
+
+namespace binary_coder {
+
+    namespace {
+
+        const char* const tier_names[] = {
+            "generic", "sse2", "ssse3", "sse4.2", "avx2", "avx512",
+        };
+
+#ifdef CPU_HAVE_CPUID
+        /* Register state the OS saves on context switches (XCR0) */
+        uint64_t xgetbv0()
+        {
+            uint32_t eax, edx;
+            __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return ((uint64_t)edx << 32) | eax;
+        }
+#endif
+
+        CPUFeatures Detect()
+        {
+            CPUFeatures f;
+            memset(&f, 0, sizeof(f));
+#ifdef CPU_HAVE_CPUID
+            unsigned int eax, ebx, ecx, edx;
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+                return f;
+            }
+            f.sse2 = (edx & bit_SSE2) != 0;
+            f.ssse3 = (ecx & bit_SSSE3) != 0;
+            f.sse42 = (ecx & bit_SSE4_2) != 0;
+            f.aesni = (ecx & bit_AES) != 0;
+
+            // AVX registers are only usable when the OS saves them.
+            bool avx_os = false, avx512_os = false;
+            if ((ecx & bit_OSXSAVE) != 0 && (ecx & bit_AVX) != 0) {
+                uint64_t xcr0 = xgetbv0();
+                avx_os = (xcr0 & 0x06) == 0x06;
+                avx512_os = (xcr0 & 0xe6) == 0xe6;
+            }
+            if (__get_cpuid_max(0, NULL) >= 7) {
+                __cpuid_count(7, 0, eax, ebx, ecx, edx);
+                f.avx2 = avx_os && (ebx & bit_AVX2) != 0;
+                f.bmi2 = (ebx & bit_BMI2) != 0;
+                f.avx512 = avx512_os && (ebx & bit_AVX512F) != 0 && (ebx & bit_AVX512BW) != 0;
+            }
+#endif
+            if (f.avx512 && f.avx2 && f.bmi2 && f.sse42) {
+                f.tier = CPUTierAVX512;
+            } else if (f.avx2 && f.bmi2 && f.sse42) {
+                f.tier = CPUTierAVX2;
+            } else if (f.sse42 && f.ssse3) {
+                f.tier = CPUTierSSE42;
+            } else if (f.ssse3 && f.sse2) {
+                f.tier = CPUTierSSSE3;
+            } else if (f.sse2) {
+                f.tier = CPUTierSSE2;
+            } else {
+                f.tier = CPUTierGeneric;
+            }
+            return f;
+        }
+
+        /* Drop everything above tier */
+        void Cap(CPUFeatures& f, cpu_tier_t tier)
+        {
+            if (tier >= f.tier) {
+                return;
+            }
+            f.tier = tier;
+            if (tier < CPUTierAVX512) {
+                f.avx512 = false;
+            }
+            if (tier < CPUTierAVX2) {
+                f.avx2 = false;
+                f.bmi2 = false;
+            }
+            if (tier < CPUTierSSE42) {
+                f.sse42 = false;
+                f.aesni = false;
+            }
+            if (tier < CPUTierSSSE3) {
+                f.ssse3 = false;
+            }
+            if (tier < CPUTierSSE2) {
+                f.sse2 = false;
+            }
+        }
+
+        CPUFeatures DetectWithOverride()
+        {
+            CPUFeatures f = Detect();
+            const char* env = getenv("BINARYCODER_CPU");
+            if (env != NULL) {
+                for (int t = CPUTierGeneric; t <= CPUTierAVX512; t++) {
+                    if (strcmp(env, tier_names[t]) == 0) {
+                        Cap(f, (cpu_tier_t)t);
+                        break;
+                    }
+                }
+            }
+            return f;
+        }
+
+    } /* namespace */
+
+    const CPUFeatures& GetCPUFeatures()
+    {
+        static const CPUFeatures features = DetectWithOverride();
+        return features;
+    }
+
+    const char* CPUTierName(cpu_tier_t tier)
+    {
+        return tier_names[tier];
+    }
+
+} /* binary_coder */
@@ -0,0 +1,57 @@
+//
+//  CPUFeatures.h
+//  BinaryCoder
+//
+
+#ifndef BINARYCODER_CPUFEATURES_H_
+#define BINARYCODER_CPUFEATURES_H_
+
+#include "STDHeaders.h"
+
+namespace binary_coder {
+
+    /**
+     * Instruction set tiers, each one including the ones before it. The
+     * hot kernels (DES, checksums, memory scanning) pick their code path
+     * from the tier of the running CPU, so one build runs well on every
+     * generation of the fleet.
+     */
+    enum cpu_tier_t {
+        CPUTierGeneric = 0,
+        CPUTierSSE2,
+        CPUTierSSSE3,
+        /** SSE4.2, with CRC32 and AES-NI. */
+        CPUTierSSE42,
+        /** AVX2, with BMI2. */
+        CPUTierAVX2,
+        /** AVX-512 F and BW. */
+        CPUTierAVX512,
+    };
+
+    struct CPUFeatures {
+        cpu_tier_t tier;
+        bool sse2;
+        bool ssse3;
+        bool sse42;
+        bool aesni;
+        bool avx2;
+        bool bmi2;
+        bool avx512;
+    };
+
+    /**
+     * The features of the running CPU, detected on the first call.
+     *
+     * The environment variable BINARYCODER_CPU (generic, sse2, ssse3,
+     * sse4.2, avx2 or avx512) caps the tier, and with it every feature
+     * above it, to test the slower code paths. It never enables anything
+     * the CPU lacks.
+     */
+    const CPUFeatures& GetCPUFeatures();
+
+    /** Name of a tier, as accepted in BINARYCODER_CPU. */
+    const char* CPUTierName(cpu_tier_t tier);
+
+} /* binary_coder */
+
+#endif /* defined(BINARYCODER_CPUFEATURES_H_) */
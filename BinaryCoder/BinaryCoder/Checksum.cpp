@@ -0,0 +1,124 @@
+//
+//  Checksum.cpp
+//  BinaryCoder
+//
+
+#include "Checksum.h"
+#include "CPUFeatures.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <nmmintrin.h>
+#define CRC_HAVE_SSE42 1
+#define CRC_SSE42_TARGET __attribute__((target("sse4.2")))
+#endif
+
+namespace binary_coder {
+
+    namespace {
+
+        /* Reflected Castagnoli polynomial */
+        constexpr uint32_t poly = 0x82f63b78;
+
+        constexpr uint32_t step(uint32_t c)
+        {
+            return (c >> 1) ^ ((c & 1) ? poly : 0);
+        }
+
+        constexpr uint32_t crc_byte(uint32_t b)
+        {
+            return step(step(step(step(step(step(step(step(b))))))));
+        }
+
+        /* CRC of byte b followed by k zero bytes, for slicing-by-8 */
+        constexpr uint32_t crc_slice(int k, uint32_t b)
+        {
+            return k == 0 ? crc_byte(b)
+                : (crc_slice(k - 1, b) >> 8) ^ crc_byte(crc_slice(k - 1, b) & 0xff);
+        }
+
+#define T4(f,k,i)   f(k,i), f(k,i+1), f(k,i+2), f(k,i+3)
+#define T16(f,k,i)  T4(f,k,i), T4(f,k,i+4), T4(f,k,i+8), T4(f,k,i+12)
+#define T64(f,k,i)  T16(f,k,i), T16(f,k,i+16), T16(f,k,i+32), T16(f,k,i+48)
+#define T256(f,k)   { T64(f,k,0), T64(f,k,64), T64(f,k,128), T64(f,k,192) }
+
+        constexpr uint32_t table[8][256] = {
+            T256(crc_slice, 0), T256(crc_slice, 1), T256(crc_slice, 2), T256(crc_slice, 3),
+            T256(crc_slice, 4), T256(crc_slice, 5), T256(crc_slice, 6), T256(crc_slice, 7),
+        };
+
+        static_assert(crc_byte(1) == 0xf26b8303 && crc_slice(1, 1) == 0x13a29877,
+                      "CRC-32C table does not match the Castagnoli polynomial");
+
+        uint32_t crc_portable(uint32_t crc, const uint8_t* p, size_t n)
+        {
+            while (n > 0 && ((uintptr_t)p & 3) != 0) {
+                crc = (crc >> 8) ^ table[0][(crc ^ *p++) & 0xff];
+                n--;
+            }
+            while (n >= 8) {
+                uint32_t lo = crc ^ ((uint32_t)p[0] | ((uint32_t)p[1] << 8)
+                                     | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+                crc = table[7][lo & 0xff] ^ table[6][(lo >> 8) & 0xff]
+                    ^ table[5][(lo >> 16) & 0xff] ^ table[4][lo >> 24]
+                    ^ table[3][p[4]] ^ table[2][p[5]] ^ table[1][p[6]] ^ table[0][p[7]];
+                p += 8;
+                n -= 8;
+            }
+            while (n > 0) {
+                crc = (crc >> 8) ^ table[0][(crc ^ *p++) & 0xff];
+                n--;
+            }
+            return crc;
+        }
+
+#ifdef CRC_HAVE_SSE42
+        CRC_SSE42_TARGET
+        uint32_t crc_sse42(uint32_t crc, const uint8_t* p, size_t n)
+        {
+#ifdef __x86_64__
+            uint64_t c = crc;
+            while (n >= 8) {
+                uint64_t word;
+                memcpy(&word, p, 8);
+                c = _mm_crc32_u64(c, word);
+                p += 8;
+                n -= 8;
+            }
+            crc = (uint32_t)c;
+#endif
+            while (n >= 4) {
+                uint32_t word;
+                memcpy(&word, p, 4);
+                crc = _mm_crc32_u32(crc, word);
+                p += 4;
+                n -= 4;
+            }
+            while (n > 0) {
+                crc = _mm_crc32_u8(crc, *p++);
+                n--;
+            }
+            return crc;
+        }
+#endif
+
+        typedef uint32_t (*crc_fn)(uint32_t, const uint8_t*, size_t);
+
+        crc_fn SelectCRC()
+        {
+#ifdef CRC_HAVE_SSE42
+            if (GetCPUFeatures().sse42) {
+                return crc_sse42;
+            }
+#endif
+            return crc_portable;
+        }
+
+    } /* namespace */
+
+    uint32_t CRC32C(const void* data, size_t length, uint32_t crc)
+    {
+        static const crc_fn kernel = SelectCRC();
+        return ~kernel(~crc, (const uint8_t*)data, length);
+    }
+
+} /* binary_coder */
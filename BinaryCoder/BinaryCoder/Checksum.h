@@ -0,0 +1,25 @@
+//
+//  Checksum.h
+//  BinaryCoder
+//
+
+#ifndef BINARYCODER_CHECKSUM_H_
+#define BINARYCODER_CHECKSUM_H_
+
+#include "STDHeaders.h"
+
+namespace binary_coder {
+
+    /**
+     * CRC-32C (Castagnoli) of length bytes, continuing from crc, the value
+     * returned for the data before them (0 to start). Uses the SSE4.2
+     * CRC32 instruction when the CPU has it (see CPUFeatures.h) and
+     * slicing-by-8 tables otherwise; both give the same result.
+     *
+     * CRC32C("123456789", 9) == 0xe3069283.
+     */
+    uint32_t CRC32C(const void* data, size_t length, uint32_t crc = 0);
+
+} /* binary_coder */
+
+#endif /* defined(BINARYCODER_CHECKSUM_H_) */
@@ -6,8 +6,22 @@
 namespace binary_coder {
     /** The default size, in bytes, for the internal buffer. */
 #define BUFFER_SIZE 4096
+    /** The smallest buffer, in bytes, an Encoder or Decoder is given; its widest load is 8 bytes. */
+#define MIN_BUFFER_SIZE 16
+    /** The default largest read size, in bytes, of a Decoder with an adaptive buffer. */
+#define MAX_BUFFER_SIZE 1048576
+    /** The number of refills in a row without a jump after which an adaptive Decoder doubles its read size. */
+#define GROW_AFTER_REFILLS 4
+    /** The default size, in bytes, of each of the two blocks of an InputReadAhead. */
+#define READ_AHEAD_SIZE 65536
     /** The default size, in bytes, for the reading strings. */
 #define STR_BUFFER_SIZE 1024
+    /** The default number of bytes a Decoder keeps behind the read position for Reset(). */
+#define WINDOW_LIMIT 65536
+    /** The default size, in bytes, from which cipher work is split over a WorkerPool. */
+#define PARALLEL_THRESHOLD 262144
+    /** The default number of key schedules kept by a DESKeyCache. */
+#define KEY_CACHE_SIZE 4096
     /** Bit mask applied to bytes when converting to unsigned integers. */
 #define BYTE_MASK 255
     /** Number of bits to shift when aligning a value to the second byte. */
@@ -61,6 +75,8 @@ namespace binary_coder {
         FailedToWrite,
         StreamIsClosed,
         InvalidData,
+        /// A stream that cannot seek was asked to go back.
+        FailedToSeek,
     };
 } /* binary_coder */
 
@@ -7,43 +7,205 @@
 //
 
 #include "CrypticStream.h"
+#include "WorkerPool.h"
+#include "DESKeyCache.h"
 
 namespace binary_coder {
     
-    InputStreamDES::InputStreamDES(InputStream* s, size_t encrypted_bytes, bool retain/* = false*/)
+    void DESCryptECB(DES_KS ks, uint8_t* data, size_t blocks, WorkerPool* pool, size_t threshold)
+    {
+        ParallelRanges(pool, blocks, desbs_width(), threshold >> 3, [&](size_t begin, size_t end) {
+            desecb(ks, data + (begin << 3), end - begin);
+        });
+    }
+    
+    void DES3CryptECB(DES3_KS ks, uint8_t* data, size_t blocks, WorkerPool* pool, size_t threshold)
+    {
+        ParallelRanges(pool, blocks, desbs_width(), threshold >> 3, [&](size_t begin, size_t end) {
+            des3ecb(ks, data + (begin << 3), end - begin);
+        });
+    }
+    
+    /* Number of keystream blocks generated at once on the stack. */
+#define CTR_BATCH_BLOCKS 512
+    
+    void DESCryptCTR(DES_KS ks, const uint8_t iv[8], uint64_t offset, uint8_t* data, size_t length,
+                     WorkerPool* pool, size_t threshold)
+    {
+        if (length == 0) {
+            return;
+        }
+        uint64_t counter0 = 0;
+        for (int i = 0; i < 8; i++) {
+            counter0 = (counter0 << 8) | iv[i];
+        }
+        uint64_t first = offset >> 3;
+        size_t blocks = (size_t)(((offset + length + 7) >> 3) - first);
+        
+        ParallelRanges(pool, blocks, CTR_BATCH_BLOCKS, threshold >> 3, [&](size_t begin, size_t end) {
+            uint8_t stream[CTR_BATCH_BLOCKS*8];
+            while (begin < end) {
+                size_t n = end - begin > CTR_BATCH_BLOCKS? CTR_BATCH_BLOCKS: end - begin;
+                for (size_t b = 0; b < n; b++) {
+                    uint64_t counter = counter0 + first + begin + b;
+                    uint8_t* block = stream + (b << 3);
+                    for (int i = 7; i >= 0; i--) {
+                        block[i] = (uint8_t)counter;
+                        counter >>= 8;
+                    }
+                }
+                desecb(ks, stream, n);
+                
+                // XOR the part of the keystream that overlaps data.
+                uint64_t from = (first + begin) << 3;
+                uint64_t to = (first + begin + n) << 3;
+                if (from < offset) {
+                    from = offset;
+                }
+                if (to > offset + length) {
+                    to = offset + length;
+                }
+                const uint8_t* key = stream + (from - ((first + begin) << 3));
+                uint8_t* p = data + (from - offset);
+                for (uint64_t i = 0; i < to - from; i++) {
+                    p[i] ^= key[i];
+                }
+                begin += n;
+            }
+        });
+    }
+    
+    /* Number of ciphertext blocks kept aside at once while decrypting CBC in place. */
+#define CBC_BATCH_BLOCKS 512
+    
+    void DESDecryptCBC(DES_KS ks, const uint8_t prev[8], uint8_t* data, size_t blocks,
+                       WorkerPool* pool, size_t threshold)
+    {
+        if (blocks == 0) {
+            return;
+        }
+        // Every range chains from the ciphertext block just before it, which
+        // the range in front may overwrite, so take them all aside first.
+        size_t per_range = RangeLength(pool, blocks, desbs_width(), threshold >> 3);
+        size_t ranges = (blocks + per_range - 1) / per_range;
+        std::vector<uint8_t> chains(ranges << 3);
+        memcpy(&chains[0], prev, 8);
+        for (size_t i = 1; i < ranges; i++) {
+            memcpy(&chains[i << 3], data + ((i * per_range - 1) << 3), 8);
+        }
+        
+        ParallelRanges(pool, blocks, desbs_width(), threshold >> 3, [&](size_t begin, size_t end) {
+            uint8_t cipher[CBC_BATCH_BLOCKS*8];
+            uint8_t chain[8];
+            memcpy(chain, &chains[(begin / per_range) << 3], 8);
+            while (begin < end) {
+                size_t n = end - begin > CBC_BATCH_BLOCKS? CBC_BATCH_BLOCKS: end - begin;
+                uint8_t* p = data + (begin << 3);
+                memcpy(cipher, p, n << 3);
+                desecb(ks, p, n);
+                for (int i = 0; i < 8; i++) {
+                    p[i] ^= chain[i];
+                }
+                for (size_t i = 8; i < (n << 3); i++) {
+                    p[i] ^= cipher[i - 8];
+                }
+                memcpy(chain, cipher + ((n - 1) << 3), 8);
+                begin += n;
+            }
+        });
+    }
+    
+    //////////////////////////////////////////////////////////////////////////
+    
+    InputStreamCipher::InputStreamCipher(InputStream* s, const BlockCipher* cipher, size_t encrypted_bytes, bool retain/* = false*/, size_t window_size/* = 4096*/)
+    {
+        cipher_ = cipher;
+        block_size_ = cipher->BlockSize();
+        _Init(s, encrypted_bytes, retain, window_size);
+    }
+    
+    InputStreamCipher::InputStreamCipher(InputStream* s, size_t block_size, size_t encrypted_bytes, bool retain, size_t window_size)
+    {
+        cipher_ = NULL;
+        block_size_ = block_size;
+        _Init(s, encrypted_bytes, retain, window_size);
+    }
+    
+    void InputStreamCipher::_Init(InputStream* s, size_t encrypted_bytes, bool retain, size_t window_size)
     {
         stream_ = s;
         start_ = s->Tell();
-        s->Seek(0, SEEK_END);
-        size_t end = s->Tell();
-        s->Seek(start_, SEEK_SET);
-        size_t length = end-start_;
-        if (encrypted_bytes < length) {
-            length_ = encrypted_bytes;
-        } else {
-            length_ = length;
-        }
+        // The length is only learnt from s when it is needed, so a stream
+        // read front to back is never sought; until then the data ends
+        // where s does.
+        length_ = encrypted_bytes;
+        length_known_ = false;
         position_ = 0;
-        block_info_.index = 0;
-        block_info_.dirty = 1;
+        stream_pos_ = start_;
+        
+        window_size_ = window_size >= block_size_? (window_size & ~(block_size_ - 1)): block_size_;
+        window_ = (uint8_t*)malloc(window_size_);
+        window_start_ = 0;
+        window_bytes_ = 0;
+        
         retain_ = retain;
+        pool_ = NULL;
+        parallel_threshold_ = PARALLEL_THRESHOLD;
         err_ = NoError;
     }
     
-    InputStreamDES::~InputStreamDES()
+    InputStreamCipher::~InputStreamCipher()
     {
+        free(window_);
+        window_ = NULL;
+        
         if (retain_ && stream_ != NULL) {
             delete stream_;
             stream_ = NULL;
         }
     }
     
-    void InputStreamDES::setDESKey(const uint8_t key[8])
+    void InputStreamCipher::setWorkerPool(WorkerPool* pool, size_t threshold)
     {
-        deskey(ks_, (unsigned char*)key, 1);
+        pool_ = pool;
+        parallel_threshold_ = threshold;
     }
     
-    int InputStreamDES::Seek(long offset, int origin)
+    bool InputStreamCipher::_LearnLength()
+    {
+        if (length_known_) {
+            return true;
+        }
+        if (stream_->Seek(0, SEEK_END) != 0) {
+            return false;
+        }
+        size_t end = stream_->Tell();
+        if (stream_->Seek(stream_pos_, SEEK_SET) != 0) {
+            stream_pos_ = end;
+        }
+        if (end == (size_t)-1 || end < start_) {
+            return false;
+        }
+        if (end - start_ < length_) {
+            length_ = end - start_;
+        }
+        length_known_ = true;
+        return true;
+    }
+    
+    void InputStreamCipher::_EndAt(size_t pos, size_t bytes)
+    {
+        if (bytes % block_size_ != 0) {
+            _SetError(InvalidData);
+        }
+        pos += bytes - bytes % block_size_;
+        if (pos < length_) {
+            length_ = pos;
+        }
+        length_known_ = true;
+    }
+    
+    int InputStreamCipher::Seek(long offset, int origin)
     {
         if (err_ != NoError) {
             return -1;
@@ -52,56 +214,117 @@ namespace binary_coder {
         if (origin == SEEK_CUR) {
             begin = position_;
         } else if (origin == SEEK_END) {
+            if (!_LearnLength()) {
+                return -1;
+            }
             begin = length_;
         }
         position_ = begin + offset;
         return 0;
     }
     
-    size_t InputStreamDES::Read(void* ptr, size_t size, size_t count)
+    size_t InputStreamCipher::_ReadBlocks(size_t pos, uint8_t* dst, size_t count)
     {
-        if (err_ != NoError) {
+        size_t at = start_ + pos;
+        if (stream_pos_ != at) {
+            if (stream_->Seek(at, SEEK_SET) != 0) {
+                _SetError(FailedToRead);
+                return 0;
+            }
+            stream_pos_ = at;
+        }
+        size_t bytes = stream_->Read(dst, 1, count * block_size_);
+        stream_pos_ += bytes;
+        if (bytes < count * block_size_) {
+            _EndAt(pos, bytes);
+        }
+        size_t c = bytes / block_size_;
+        _Decrypt(dst, c);
+        return c;
+    }
+    
+    void InputStreamCipher::_Decrypt(uint8_t* data, size_t count)
+    {
+        CipherECB(*cipher_, true, data, count, pool_, parallel_threshold_);
+    }
+    
+    size_t InputStreamCipher::Read(void* ptr, size_t size, size_t count)
+    {
+        if (err_ != NoError || position_ >= length_) {
             return 0;
         }
         
         uint8_t* start = (uint8_t*)ptr;
-        uint8_t* end = start + size*count;
         uint8_t* p = start;
+        size_t wanted = size*count;
+        if (wanted > length_ - position_) {
+            wanted = length_ - position_;
+        }
+        uint8_t* end = start + wanted;
+        size_t block_mask = block_size_ - 1;
+        
         while (p < end) {
-            if (block_info_.dirty || block_info_.index != (position_>>3)) {
-                block_info_.index = (position_>>3);
-                size_t pos = start_ + (block_info_.index << 3);
-                if (stream_->Tell() != pos) {
-                    stream_->Seek(pos, SEEK_SET);
+            // Serve what the window already holds.
+            if (position_ >= window_start_ && position_ < window_start_ + window_bytes_) {
+                size_t n = window_start_ + window_bytes_ - position_;
+                if (n > (size_t)(end - p)) {
+                    n = end - p;
                 }
-                size_t c = stream_->Read(block_, 8, 1);
-                if (c < 8) {
-                    _SetError(InvalidData);
+                memcpy(p, window_ + (position_ - window_start_), n);
+                position_ += n;
+                p += n;
+                continue;
+            }
+            if (position_ >= length_) {
+                // The data ended before the read did.
+                break;
+            }
+            
+            // Whole blocks on a block boundary are read straight into the
+            // caller's buffer and decrypted there in one go.
+            size_t blocks = (end - p) / block_size_;
+            if ((position_ & block_mask) == 0 && blocks > 0) {
+                size_t c = _ReadBlocks(position_, p, blocks);
+                position_ += c * block_size_;
+                p += c * block_size_;
+                if (c < blocks) {
+                    // The data ended early, or could not be read.
+                    if (position_ < length_) {
+                        _SetError(InvalidData);
+                    }
                     break;
                 }
-                
-                des(ks_, block_);
-                
-                block_info_.dirty = 0;
+                continue;
             }
             
-            int n = p+8>end? (int)(p+8-end): 8;
-            for (int i=0; i<n; i++) {
-                p[i] = block_[i];
+            // A partial block: decrypt a whole window of blocks around it,
+            // so the following small reads are served from memory.
+            size_t from = position_ & ~block_mask;
+            size_t left = length_ - from;
+            size_t n = left / block_size_ + (left % block_size_ != 0? 1: 0);
+            if (n > window_size_ / block_size_) {
+                n = window_size_ / block_size_;
+            }
+            window_start_ = from;
+            window_bytes_ = _ReadBlocks(from, window_, n) * block_size_;
+            if (position_ >= window_start_ + window_bytes_) {
+                window_bytes_ = 0;
+                if (position_ < length_) {
+                    _SetError(InvalidData);
+                }
+                break;
             }
-            position_ += n;
-            p += n;
         }
     
         return p - start;
     }
     
-    size_t InputStreamDES::Tell() const
+    size_t InputStreamCipher::Tell() const
     {
         return position_;
     }
     
-    int InputStreamDES::Eof() const
+    int InputStreamCipher::Eof() const
     {
         if (position_ >= length_) {
             return 1;
@@ -112,15 +335,31 @@ namespace binary_coder {
     
     //////////////////////////////////////////////////////////////////////////
     
-    OutputStreamDES::OutputStreamDES(OutputStream* s, size_t preferred_buffer_size, bool retain/* = false*/)
+    OutputStreamCipher::OutputStreamCipher(OutputStream* s, const BlockCipher* cipher, size_t preferred_buffer_size, bool retain/* = false*/)
+    {
+        cipher_ = cipher;
+        block_size_ = cipher->BlockSize();
+        _Init(s, preferred_buffer_size, retain);
+    }
+    
+    OutputStreamCipher::OutputStreamCipher(OutputStream* s, size_t block_size, size_t preferred_buffer_size, bool retain)
+    {
+        cipher_ = NULL;
+        block_size_ = block_size;
+        _Init(s, preferred_buffer_size, retain);
+    }
+    
+    void OutputStreamCipher::_Init(OutputStream* s, size_t preferred_buffer_size, bool retain)
     {
         stream_ = s;
         retain_ = retain;
         err_ = NoError;
         is_sealed_ = false;
+        pool_ = NULL;
+        parallel_threshold_ = PARALLEL_THRESHOLD;
         
-        if (preferred_buffer_size >= 64) {
-            buffer_size_ = (preferred_buffer_size + 7) & ~0x07;
+        if (preferred_buffer_size >= 8*block_size_) {
+            buffer_size_ = (preferred_buffer_size + block_size_ - 1) & ~(block_size_ - 1);
         } else {
             buffer_size_ = 4096;
         }
@@ -128,7 +367,7 @@ namespace binary_coder {
         bytes_in_buffer_ = 0;
     }
     
-    OutputStreamDES::~OutputStreamDES()
+    OutputStreamCipher::~OutputStreamCipher()
     {
         if (!is_sealed_) {
             Seal();
@@ -143,12 +382,13 @@ namespace binary_coder {
         }
     }
     
-    void OutputStreamDES::setDESKey(const uint8_t key[8])
+    void OutputStreamCipher::setWorkerPool(WorkerPool* pool, size_t threshold)
     {
-        deskey(ks_, (unsigned char*)key, 0);
+        pool_ = pool;
+        parallel_threshold_ = threshold;
     }
     
-    size_t OutputStreamDES::Write(const void* ptr, size_t size, size_t count)
+    size_t OutputStreamCipher::Write(const void* ptr, size_t size, size_t count)
     {
         if (err_ != NoError) {
             return 0;
@@ -182,35 +422,54 @@ namespace binary_coder {
         return total - left;
     }
     
-    void OutputStreamDES::Flush()
+    uint8_t* OutputStreamCipher::Reserve(size_t min, size_t* length)
+    {
+        *length = 0;
+        if (err_ != NoError || is_sealed_) {
+            return NULL;
+        }
+        if (buffer_size_ - bytes_in_buffer_ < min) {
+            _Flush(false);
+            if (err_ != NoError || buffer_size_ - bytes_in_buffer_ < min) {
+                return NULL;
+            }
+        }
+        *length = buffer_size_ - bytes_in_buffer_;
+        return buffer_ + bytes_in_buffer_;
+    }
+    
+    void OutputStreamCipher::Commit(size_t count)
+    {
+        assert(count <= buffer_size_ - bytes_in_buffer_);
+        bytes_in_buffer_ += count;
+    }
+    
+    void OutputStreamCipher::Flush()
     {
         _Flush(false);
     }
     
-    void OutputStreamDES::Seal()
+    void OutputStreamCipher::Seal()
     {
         _Flush(true);
         is_sealed_ = true;
     }
     
-    void OutputStreamDES::_Flush(bool bSeal)
+    void OutputStreamCipher::_Flush(bool bSeal)
     {
         if (bytes_in_buffer_ > 0) {
-            size_t l = bytes_in_buffer_ & (~0x07);
+            size_t l = bytes_in_buffer_ & ~(block_size_ - 1);
             uint8_t* ptr = buffer_;
             if (l > 0) {
-                uint8_t* end = buffer_ + l;
-                while (ptr < end) {
-                    des(ks_, ptr);
-                    ptr += 8;
-                }
+                _Encrypt(buffer_, l / block_size_);
+                ptr += l;
             }
             
             size_t remains = bytes_in_buffer_ - l;
-            assert(remains >= 0 && remains < 8);
+            assert(remains < block_size_);
             if (bSeal && remains > 0) {
-                des(ks_, ptr);
-                l += 8;
+                _Encrypt(ptr, 1);
+                l += block_size_;
                 remains = 0;
             }
             
@@ -219,7 +478,7 @@ namespace binary_coder {
                 stream_->Flush();
                 
                 if (remains > 0) {
-                    for (int i=0; i<remains; i++) {
+                    for (size_t i=0; i<remains; i++) {
                         buffer_[i] = buffer_[l+i];
                     }
                 }
@@ -227,4 +486,508 @@ namespace binary_coder {
             }
         }
     }
+    
+    void OutputStreamCipher::_Encrypt(uint8_t* data, size_t count)
+    {
+        CipherECB(*cipher_, false, data, count, pool_, parallel_threshold_);
+    }
+    
+    //////////////////////////////////////////////////////////////////////////
+    
+    InputStreamDES::InputStreamDES(InputStream* s, size_t encrypted_bytes, bool retain/* = false*/, size_t window_size/* = 4096*/)
+    : InputStreamCipher(s, 8, encrypted_bytes, retain, window_size)
+    {
+    }
+    
+    void InputStreamDES::setDESKey(const uint8_t key[8])
+    {
+        DESKeyCache::Shared().Schedule(ks_, key, 1);
+        window_bytes_ = 0;
+    }
+    
+    void InputStreamDES::_Decrypt(uint8_t* data, size_t count)
+    {
+        DESCryptECB(ks_, data, count, pool_, parallel_threshold_);
+    }
+    
+    //////////////////////////////////////////////////////////////////////////
+    
+    OutputStreamDES::OutputStreamDES(OutputStream* s, size_t preferred_buffer_size, bool retain/* = false*/)
+    : OutputStreamCipher(s, 8, preferred_buffer_size, retain)
+    {
+    }
+    
+    OutputStreamDES::~OutputStreamDES()
+    {
+        if (!is_sealed_) {
+            Seal();
+        }
+    }
+    
+    void OutputStreamDES::setDESKey(const uint8_t key[8])
+    {
+        DESKeyCache::Shared().Schedule(ks_, key, 0);
+    }
+    
+    void OutputStreamDES::_Encrypt(uint8_t* data, size_t count)
+    {
+        DESCryptECB(ks_, data, count, pool_, parallel_threshold_);
+    }
+    
+    //////////////////////////////////////////////////////////////////////////
+    
+    InputStreamDES3::InputStreamDES3(InputStream* s, size_t encrypted_bytes, bool retain/* = false*/, size_t window_size/* = 4096*/)
+    : InputStreamDES(s, encrypted_bytes, retain, window_size)
+    {
+    }
+    
+    void InputStreamDES3::setDESKey(const uint8_t key[8])
+    {
+        uint8_t key3[24];
+        memcpy(key3, key, 8);
+        memcpy(key3 + 8, key, 8);
+        memcpy(key3 + 16, key, 8);
+        setDES3Key(key3);
+    }
+    
+    void InputStreamDES3::setDES3Key(const uint8_t key[24])
+    {
+        DESKeyCache::Shared().Schedule3(ks3_, key, 1);
+        window_bytes_ = 0;
+    }
+    
+    void InputStreamDES3::_Decrypt(uint8_t* data, size_t count)
+    {
+        DES3CryptECB(ks3_, data, count, pool_, parallel_threshold_);
+    }
+    
+    //////////////////////////////////////////////////////////////////////////
+    
+    OutputStreamDES3::OutputStreamDES3(OutputStream* s, size_t preferred_buffer_size, bool retain/* = false*/)
+    : OutputStreamDES(s, preferred_buffer_size, retain)
+    {
+    }
+    
+    OutputStreamDES3::~OutputStreamDES3()
+    {
+        if (!is_sealed_) {
+            Seal();
+        }
+    }
+    
+    void OutputStreamDES3::setDESKey(const uint8_t key[8])
+    {
+        uint8_t key3[24];
+        memcpy(key3, key, 8);
+        memcpy(key3 + 8, key, 8);
+        memcpy(key3 + 16, key, 8);
+        setDES3Key(key3);
+    }
+    
+    void OutputStreamDES3::setDES3Key(const uint8_t key[24])
+    {
+        DESKeyCache::Shared().Schedule3(ks3_, key, 0);
+    }
+    
+    void OutputStreamDES3::_Encrypt(uint8_t* data, size_t count)
+    {
+        DES3CryptECB(ks3_, data, count, pool_, parallel_threshold_);
+    }
+    
+    //////////////////////////////////////////////////////////////////////////
+    
+    InputStreamDESCTR::InputStreamDESCTR(InputStream* s, size_t encrypted_bytes, bool retain/* = false*/)
+    {
+        stream_ = s;
+        retain_ = retain;
+        pool_ = NULL;
+        parallel_threshold_ = PARALLEL_THRESHOLD;
+        position_ = 0;
+        err_ = NoError;
+        memset(iv_, 0, sizeof(iv_));
+        
+        // Like InputStreamCipher, the length is learnt from s only for
+        // Seek(0, SEEK_END), so s may be a stream that cannot seek.
+        size_t header = s->Tell();
+        length_known_ = false;
+        if (s->Read(iv_, 1, 8) != 8) {
+            _SetError(InvalidData);
+            start_ = header;
+            length_ = 0;
+        } else {
+            start_ = header + 8;
+            length_ = encrypted_bytes;
+        }
+        stream_pos_ = start_;
+    }
+    
+    InputStreamDESCTR::~InputStreamDESCTR()
+    {
+        if (retain_ && stream_ != NULL) {
+            delete stream_;
+            stream_ = NULL;
+        }
+    }
+    
+    void InputStreamDESCTR::setDESKey(const uint8_t key[8])
+    {
+        DESKeyCache::Shared().Schedule(ks_, key, 0);
+    }
+    
+    void InputStreamDESCTR::setWorkerPool(WorkerPool* pool, size_t threshold)
+    {
+        pool_ = pool;
+        parallel_threshold_ = threshold;
+    }
+    
+    int InputStreamDESCTR::Seek(long offset, int origin)
+    {
+        if (err_ != NoError) {
+            return -1;
+        }
+        size_t begin = 0;
+        if (origin == SEEK_CUR) {
+            begin = position_;
+        } else if (origin == SEEK_END) {
+            if (!length_known_) {
+                if (stream_->Seek(0, SEEK_END) != 0) {
+                    return -1;
+                }
+                size_t end = stream_->Tell();
+                if (stream_->Seek(stream_pos_, SEEK_SET) != 0) {
+                    stream_pos_ = end;
+                }
+                if (end == (size_t)-1 || end < start_) {
+                    return -1;
+                }
+                if (end - start_ < length_) {
+                    length_ = end - start_;
+                }
+                length_known_ = true;
+            }
+            begin = length_;
+        }
+        position_ = begin + offset;
+        return 0;
+    }
+    
+    size_t InputStreamDESCTR::Read(void* ptr, size_t size, size_t count)
+    {
+        if (err_ != NoError || position_ >= length_) {
+            return 0;
+        }
+        size_t wanted = size*count;
+        if (wanted > length_ - position_) {
+            wanted = length_ - position_;
+        }
+        
+        size_t at = start_ + position_;
+        if (stream_pos_ != at) {
+            if (stream_->Seek(at, SEEK_SET) != 0) {
+                _SetError(FailedToRead);
+                return 0;
+            }
+            stream_pos_ = at;
+        }
+        size_t read = stream_->Read(ptr, 1, wanted);
+        stream_pos_ += read;
+        DESCryptCTR(ks_, iv_, position_, (uint8_t*)ptr, read, pool_, parallel_threshold_);
+        position_ += read;
+        if (read < wanted) {
+            // The data ends where s does.
+            if (stream_->Error() != NoError) {
+                _SetError(FailedToRead);
+            }
+            length_ = position_;
+            length_known_ = true;
+        }
+        return read;
+    }
+    
+    size_t InputStreamDESCTR::Tell() const
+    {
+        return position_;
+    }
+    
+    int InputStreamDESCTR::Eof() const
+    {
+        if (position_ >= length_) {
+            return 1;
+        } else {
+            return 0;
+        }
+    }
+    
+    //////////////////////////////////////////////////////////////////////////
+    
+    OutputStreamDESCTR::OutputStreamDESCTR(OutputStream* s, const uint8_t iv[8], size_t preferred_buffer_size, bool retain/* = false*/)
+    {
+        stream_ = s;
+        memcpy(iv_, iv, 8);
+        retain_ = retain;
+        err_ = NoError;
+        is_sealed_ = false;
+        header_written_ = false;
+        pool_ = NULL;
+        parallel_threshold_ = PARALLEL_THRESHOLD;
+        position_ = 0;
+        
+        if (preferred_buffer_size >= 64) {
+            buffer_size_ = preferred_buffer_size;
+        } else {
+            buffer_size_ = 4096;
+        }
+        buffer_ = (uint8_t*)malloc(buffer_size_);
+        bytes_in_buffer_ = 0;
+    }
+    
+    OutputStreamDESCTR::~OutputStreamDESCTR()
+    {
+        if (!is_sealed_) {
+            Seal();
+        }
+        
+        free(buffer_);
+        buffer_ = NULL;
+        
+        if (retain_ && stream_ != NULL) {
+            delete stream_;
+            stream_ = NULL;
+        }
+    }
+    
+    void OutputStreamDESCTR::setDESKey(const uint8_t key[8])
+    {
+        DESKeyCache::Shared().Schedule(ks_, key, 0);
+    }
+    
+    void OutputStreamDESCTR::setWorkerPool(WorkerPool* pool, size_t threshold)
+    {
+        pool_ = pool;
+        parallel_threshold_ = threshold;
+    }
+    
+    size_t OutputStreamDESCTR::Write(const void* ptr, size_t size, size_t count)
+    {
+        if (err_ != NoError) {
+            return 0;
+        }
+        if (is_sealed_) {
+            _SetError(StreamIsClosed);
+            return 0;
+        }
+        
+        size_t total = size*count;
+        size_t left = total;
+        const uint8_t* src = (const uint8_t*)ptr;
+        while (left > 0 && err_ == NoError) {
+            if (bytes_in_buffer_ == buffer_size_) {
+                _Flush();
+                continue;
+            }
+            size_t n = buffer_size_ - bytes_in_buffer_;
+            if (n > left) {
+                n = left;
+            }
+            memcpy(buffer_ + bytes_in_buffer_, src, n);
+            src += n;
+            left -= n;
+            bytes_in_buffer_ += n;
+        }
+        return total - left;
+    }
+    
+    uint8_t* OutputStreamDESCTR::Reserve(size_t min, size_t* length)
+    {
+        *length = 0;
+        if (err_ != NoError || is_sealed_) {
+            return NULL;
+        }
+        if (buffer_size_ - bytes_in_buffer_ < min) {
+            _Flush();
+            if (err_ != NoError || buffer_size_ < min) {
+                return NULL;
+            }
+        }
+        *length = buffer_size_ - bytes_in_buffer_;
+        return buffer_ + bytes_in_buffer_;
+    }
+    
+    void OutputStreamDESCTR::Commit(size_t count)
+    {
+        assert(count <= buffer_size_ - bytes_in_buffer_);
+        bytes_in_buffer_ += count;
+    }
+    
+    void OutputStreamDESCTR::Flush()
+    {
+        _Flush();
+        stream_->Flush();
+    }
+    
+    void OutputStreamDESCTR::Seal()
+    {
+        _Flush();
+        stream_->Flush();
+        is_sealed_ = true;
+    }
+    
+    void OutputStreamDESCTR::_Flush()
+    {
+        if (err_ != NoError) {
+            return;
+        }
+        if (!header_written_) {
+            if (stream_->Write(iv_, 1, 8) != 8) {
+                _SetError(FailedToWrite);
+                return;
+            }
+            header_written_ = true;
+        }
+        if (bytes_in_buffer_ > 0) {
+            DESCryptCTR(ks_, iv_, position_, buffer_, bytes_in_buffer_, pool_, parallel_threshold_);
+            if (stream_->Write(buffer_, 1, bytes_in_buffer_) != bytes_in_buffer_) {
+                _SetError(FailedToWrite);
+            }
+            position_ += bytes_in_buffer_;
+            bytes_in_buffer_ = 0;
+        }
+    }
+    
+    //////////////////////////////////////////////////////////////////////////
+    
+    static size_t HeaderAndBytes(size_t encrypted_bytes)
+    {
+        return encrypted_bytes > (size_t)-1 - 8? (size_t)-1: encrypted_bytes + 8;
+    }
+    
+    InputStreamDESCBC::InputStreamDESCBC(InputStream* s, size_t encrypted_bytes, bool retain/* = false*/, size_t window_size/* = 4096*/)
+    : InputStreamDES(s, HeaderAndBytes(encrypted_bytes), retain, window_size)
+    {
+        memset(iv_, 0, sizeof(iv_));
+        // The padding is in the last block, so the length must be known.
+        if (!_LearnLength() || length_ < 8 || stream_->Read(iv_, 1, 8) != 8) {
+            _SetError(InvalidData);
+            cipher_length_ = 0;
+        } else {
+            start_ += 8;
+            stream_pos_ = start_;
+            cipher_length_ = length_ - 8;
+            if ((cipher_length_ & 0x07) != 0 || cipher_length_ == 0) {
+                _SetError(InvalidData);
+            }
+        }
+        length_ = cipher_length_;
+        memcpy(chain_, iv_, 8);
+        chain_pos_ = 0;
+    }
+    
+    void InputStreamDESCBC::setDESKey(const uint8_t key[8])
+    {
+        InputStreamDES::setDESKey(key);
+        if (err_ != NoError) {
+            return;
+        }
+        
+        uint8_t last[8];
+        if (_ReadBlocks(cipher_length_ - 8, last, 1) != 1) {
+            _SetError(InvalidData);
+            return;
+        }
+        uint8_t padding = last[7];
+        if (padding < 1 || padding > 8) {
+            _SetError(InvalidData);
+            return;
+        }
+        for (int i = 8 - padding; i < 8; i++) {
+            if (last[i] != padding) {
+                _SetError(InvalidData);
+                return;
+            }
+        }
+        length_ = cipher_length_ - padding;
+    }
+    
+    size_t InputStreamDESCBC::_ReadBlocks(size_t pos, uint8_t* dst, size_t count)
+    {
+        // Reading on from the last block only needs the saved chain, any
+        // other position reads the ciphertext block in front of it too.
+        uint8_t prev[8];
+        size_t at = start_ + pos;
+        if (pos == chain_pos_) {
+            memcpy(prev, chain_, 8);
+        } else if (pos == 0) {
+            memcpy(prev, iv_, 8);
+        } else {
+            at -= 8;
+        }
+        if (stream_pos_ != at) {
+            if (stream_->Seek(at, SEEK_SET) != 0) {
+                _SetError(FailedToRead);
+                return 0;
+            }
+            stream_pos_ = at;
+        }
+        if (at != start_ + pos) {
+            size_t bytes = stream_->Read(prev, 1, 8);
+            stream_pos_ += bytes;
+            if (bytes != 8) {
+                return 0;
+            }
+        }
+        
+        size_t bytes = stream_->Read(dst, 1, count << 3);
+        stream_pos_ += bytes;
+        size_t c = bytes >> 3;
+        if (c > 0) {
+            memcpy(chain_, dst + ((c - 1) << 3), 8);
+            chain_pos_ = pos + (c << 3);
+            DESDecryptCBC(ks_, prev, dst, c, pool_, parallel_threshold_);
+        }
+        return c;
+    }
+    
+    //////////////////////////////////////////////////////////////////////////
+    
+    OutputStreamDESCBC::OutputStreamDESCBC(OutputStream* s, const uint8_t iv[8], size_t preferred_buffer_size, bool retain/* = false*/)
+    : OutputStreamDES(s, preferred_buffer_size, retain)
+    {
+        memcpy(chain_, iv, 8);
+        if (stream_->Write(iv, 1, 8) != 8) {
+            _SetError(FailedToWrite);
+        }
+    }
+    
+    OutputStreamDESCBC::~OutputStreamDESCBC()
+    {
+        if (!is_sealed_) {
+            Seal();
+        }
+    }
+    
+    void OutputStreamDESCBC::Seal()
+    {
+        if (is_sealed_) {
+            return;
+        }
+        uint8_t padding = 8 - (bytes_in_buffer_ & 0x07);
+        if (bytes_in_buffer_ + padding > buffer_size_) {
+            _Flush(false);
+        }
+        memset(buffer_ + bytes_in_buffer_, padding, padding);
+        bytes_in_buffer_ += padding;
+        OutputStreamDES::Seal();
+    }
+    
+    void OutputStreamDESCBC::_Encrypt(uint8_t* data, size_t count)
+    {
+        for (size_t b = 0; b < count; b++) {
+            uint8_t* block = data + (b << 3);
+            for (int i = 0; i < 8; i++) {
+                block[i] ^= chain_[i];
+            }
+            des(ks_, block);
+            memcpy(chain_, block, 8);
+        }
+    }
 } /* binary_coder */
@@ -10,17 +10,54 @@
 #define __BinaryCoder__CrypticStream__
 
 #include "Stream.h"
-extern "C" {
-#include "des.h"
-}
+#include "BlockCipher.h"
 
 namespace binary_coder {
 
-    class InputStreamDES: public InputStream
+    class WorkerPool;
+
+    /* Encrypt or decrypt blocks (8 bytes each) in place in ECB mode.
+      The work is split over pool when data is at least threshold bytes,
+      otherwise it runs on the calling thread. pool may be NULL.
+     */
+    void DESCryptECB(DES_KS ks, uint8_t* data, size_t blocks, WorkerPool* pool, size_t threshold);
+    /* Same as DESCryptECB() with triple DES. */
+    void DES3CryptECB(DES3_KS ks, uint8_t* data, size_t blocks, WorkerPool* pool, size_t threshold);
+    /* Encrypt or decrypt bytes in place in counter mode.
+      ks           an encryption schedule (CTR only runs the cipher forwards)
+      iv           initial counter block; block n of the stream uses iv+n
+                   (big-endian, modulo 2^64) as its counter
+      offset       offset of data[0] in the stream, need not be block aligned
+      The keystream is generated in batches by the bitsliced engine and
+      split over pool when length is at least threshold bytes.
+     */
+    void DESCryptCTR(DES_KS ks, const uint8_t iv[8], uint64_t offset, uint8_t* data, size_t length,
+                     WorkerPool* pool, size_t threshold);
+    /* Decrypt blocks in place in CBC mode.
+      ks           a decryption schedule
+      prev         the ciphertext block before data[0], the IV for the first block
+      Every block decrypts on its own before being chained, so this runs on
+      the bitsliced engine and is split over pool like DESCryptECB().
+     */
+    void DESDecryptCBC(DES_KS ks, const uint8_t prev[8], uint8_t* data, size_t blocks,
+                       WorkerPool* pool, size_t threshold);
+
+    /**
+     * ECB mode streams over any BlockCipher. The encrypted data is a
+     * sequence of blocks; reads can start anywhere, so Seek() is O(1).
+     */
+    class InputStreamCipher: public InputStream
     {
     public:
-        InputStreamDES(InputStream* s, size_t encrypted_bytes=-1, bool retain = false);
-        ~InputStreamDES();
+        /* s              the encrypted stream, positioned at the first encrypted byte
+          cipher          the keyed cipher, not owned; must outlive this stream
+          encrypted_bytes number of encrypted bytes, -1 to read up to the end of s
+          retain          delete s together with this stream
+          window_size     size in bytes of the decrypted window that serves
+                          reads not covering whole blocks
+         */
+        InputStreamCipher(InputStream* s, const BlockCipher* cipher, size_t encrypted_bytes=-1, bool retain = false, size_t window_size = 4096);
+        ~InputStreamCipher();
         
         virtual int Seek(long offset, int origin);
         virtual size_t Read(void* ptr, size_t size, size_t count);
@@ -28,68 +65,374 @@ namespace binary_coder {
         virtual int Eof() const;
         virtual error_t Error() const { return err_; }
         
-        /* Set DES key.
-          key          64 bits key (only 56 bits used)
+        /* Decrypt large reads on a worker pool.
+          pool         the pool to use, not owned; NULL to decrypt on the calling thread
+          threshold    minimal number of bytes in one read to use the pool
          */
-        void setDESKey(const uint8_t key[8]);
-    private:
-        DES_KS ks_;
+        void setWorkerPool(WorkerPool* pool, size_t threshold = PARALLEL_THRESHOLD);
     protected:
+        /* For subclasses that override _Decrypt() instead of passing a cipher. */
+        InputStreamCipher(InputStream* s, size_t block_size, size_t encrypted_bytes, bool retain, size_t window_size);
+        
+        const BlockCipher* cipher_;
+        /** Block size in bytes, a power of two. */
+        size_t block_size_;
         InputStream* stream_;
         size_t start_;
+        /** Encrypted bytes, or -1 while the data runs up to the end of stream_. */
         size_t length_;
+        /** Whether length_ is checked against the end of stream_. */
+        bool length_known_;
         error_t err_;
         bool retain_;
+        WorkerPool* pool_;
+        size_t parallel_threshold_;
         
-        struct {
-            size_t dirty: 3;
-            size_t index: sizeof(size_t)-3;
-        } block_info_;
-        uint8_t block_[8];
+        /** Decrypted blocks around the last partial read. */
+        uint8_t* window_;
+        size_t window_size_;
+        /** Plain offset of the first byte in window_, always block aligned. */
+        size_t window_start_;
+        /** Number of valid bytes in window_. */
+        size_t window_bytes_;
+        /** Where the underlying stream is, so it is only sought when needed. */
+        size_t stream_pos_;
         size_t position_;
         
+        /* Read count blocks of the encrypted stream starting at the plain
+          offset pos into dst and decrypt them. Returns the number of whole
+          blocks read. */
+        virtual size_t _ReadBlocks(size_t pos, uint8_t* dst, size_t count);
+        /* Decrypt count blocks in place. */
+        virtual void _Decrypt(uint8_t* data, size_t count);
+        /* Clamp length_ to the end of the stream, seeking it to find out.
+          Returns false if the stream cannot seek. */
+        bool _LearnLength();
+        /* The stream ended bytes into a read at the plain offset pos. */
+        void _EndAt(size_t pos, size_t bytes);
+        
         void _SetError(error_t err) {
             if (err_ == NoError) {
                 err_ = err;
             }
         }
+    private:
+        void _Init(InputStream* s, size_t encrypted_bytes, bool retain, size_t window_size);
     };
     
-    class OutputStreamDES: public OutputStream
+    class OutputStreamCipher: public OutputStream
     {
     public:
-        OutputStreamDES(OutputStream* s, size_t preferred_buffer_size = 4096, bool retain = false);
-        virtual ~OutputStreamDES();
+        /* s              the stream receiving the ciphertext
+          cipher          the keyed cipher, not owned; must outlive this stream
+          preferred_buffer_size  size in bytes of the buffer encrypted at once
+          retain          delete s together with this stream
+         */
+        OutputStreamCipher(OutputStream* s, const BlockCipher* cipher, size_t preferred_buffer_size = 4096, bool retain = false);
+        virtual ~OutputStreamCipher();
         
         virtual size_t Write(const void* ptr, size_t size, size_t count);
         // Write buffers to output stream.
-        // If length of data in buffer is not the multiple of 8, the remaining bytes will not be flushed.
+        // If length of data in buffer is not the multiple of the block size, the remaining bytes will not be flushed.
         virtual void Flush();
         virtual void Seal();
         virtual error_t Error() const { return err_; }
+        /* Lend the free part of the plaintext buffer; it is encrypted in place. */
+        virtual uint8_t* Reserve(size_t min, size_t* length);
+        virtual void Commit(size_t count);
+        
+        /* Encrypt large flushes on a worker pool. Only a buffer of at least
+          threshold bytes is split, so pair this with a large preferred_buffer_size.
+          pool         the pool to use, not owned; NULL to encrypt on the calling thread
+          threshold    minimal number of bytes in one flush to use the pool
+         */
+        void setWorkerPool(WorkerPool* pool, size_t threshold = PARALLEL_THRESHOLD);
+    protected:
+        /* For subclasses that override _Encrypt() instead of passing a cipher;
+          they must Seal() in their own destructor. */
+        OutputStreamCipher(OutputStream* s, size_t block_size, size_t preferred_buffer_size, bool retain);
+        
+        const BlockCipher* cipher_;
+        /** Block size in bytes, a power of two. */
+        size_t block_size_;
+        OutputStream* stream_;
+        error_t err_;
+        bool retain_;
+        bool is_sealed_;
+        WorkerPool* pool_;
+        size_t parallel_threshold_;
+        
+        uint8_t* buffer_;
+        size_t buffer_size_;
+        size_t bytes_in_buffer_;
+        
+        void _SetError(error_t err) {
+            if (err_ == NoError) {
+                err_ = err;
+            }
+        }
+        void _Flush(bool bSeal);
+        /* Encrypt count blocks in place. */
+        virtual void _Encrypt(uint8_t* data, size_t count);
+    private:
+        void _Init(OutputStream* s, size_t preferred_buffer_size, bool retain);
+    };
+    
+    class InputStreamDES: public InputStreamCipher
+    {
+    public:
+        /* s              the encrypted stream, positioned at the first encrypted byte
+          encrypted_bytes number of encrypted bytes, -1 to read up to the end of s
+          retain          delete s together with this stream
+          window_size     size in bytes of the decrypted window that serves
+                          reads not covering whole blocks
+         */
+        InputStreamDES(InputStream* s, size_t encrypted_bytes=-1, bool retain = false, size_t window_size = 4096);
+        
+        /* Set DES key.
+          key          64 bits key (only 56 bits used)
+         */
+        virtual void setDESKey(const uint8_t key[8]);
+    protected:
+        DES_KS ks_;
+        
+        virtual void _Decrypt(uint8_t* data, size_t count);
+    };
+    
+    class OutputStreamDES: public OutputStreamCipher
+    {
+    public:
+        OutputStreamDES(OutputStream* s, size_t preferred_buffer_size = 4096, bool retain = false);
+        // Seals here, while the DES schedule is still reachable.
+        virtual ~OutputStreamDES();
         
         /* Set DES key.
          key          64 bits key (only 56 bits used)
          */
+        virtual void setDESKey(const uint8_t key[8]);
+    protected:
+        DES_KS ks_;
+        
+        virtual void _Encrypt(uint8_t* data, size_t count);
+    };
+    
+    /**
+     * Triple DES (EDE3) variants of the DES streams. They share everything
+     * with InputStreamDES/OutputStreamDES except the cipher, which runs the
+     * three DES stages fused (see des3port.c and desbs.cpp).
+     */
+    class InputStreamDES3: public InputStreamDES
+    {
+    public:
+        InputStreamDES3(InputStream* s, size_t encrypted_bytes=-1, bool retain = false, size_t window_size = 4096);
+        
+        /* Set a single DES key, used as K1 = K2 = K3. The result is the
+          same as InputStreamDES with that key.
+         */
+        virtual void setDESKey(const uint8_t key[8]);
+        
+        /* Set triple DES key.
+          key          K1, K2 and K3, 64 bits each (only 56 bits used)
+         */
+        void setDES3Key(const uint8_t key[24]);
+    protected:
+        virtual void _Decrypt(uint8_t* data, size_t count);
+    private:
+        DES3_KS ks3_;
+    };
+    
+    class OutputStreamDES3: public OutputStreamDES
+    {
+    public:
+        OutputStreamDES3(OutputStream* s, size_t preferred_buffer_size = 4096, bool retain = false);
+        // Seals here, while the triple DES schedule is still reachable.
+        virtual ~OutputStreamDES3();
+        
+        /* Set a single DES key, used as K1 = K2 = K3. The result is the
+         same as OutputStreamDES with that key.
+         */
+        virtual void setDESKey(const uint8_t key[8]);
+        
+        /* Set triple DES key.
+         key          K1, K2 and K3, 64 bits each (only 56 bits used)
+         */
+        void setDES3Key(const uint8_t key[24]);
+    protected:
+        virtual void _Encrypt(uint8_t* data, size_t count);
+    private:
+        DES3_KS ks3_;
+    };
+
+    /**
+     * Counter mode DES streams. Unlike ECB, equal plaintext blocks do not
+     * give equal ciphertext, yet any byte can still be decrypted on its
+     * own, so Seek() is O(1) and costs nothing until the next Read().
+     *
+     * Format: the 8-byte initial counter block in clear, then the
+     * ciphertext, exactly as long as the plaintext (no padding).
+     */
+    class InputStreamDESCTR: public InputStream
+    {
+    public:
+        /* s              the encrypted stream, positioned at the header
+          encrypted_bytes number of bytes after the header, -1 to read up to the end of s
+          retain          delete s together with this stream
+         */
+        InputStreamDESCTR(InputStream* s, size_t encrypted_bytes=-1, bool retain = false);
+        ~InputStreamDESCTR();
+        
+        virtual int Seek(long offset, int origin);
+        virtual size_t Read(void* ptr, size_t size, size_t count);
+        virtual size_t Tell() const;
+        virtual int Eof() const;
+        virtual error_t Error() const { return err_; }
+        
+        /* Set DES key.
+          key          64 bits key (only 56 bits used)
+         */
         void setDESKey(const uint8_t key[8]);
+        
+        /* Generate the keystream of large reads on a worker pool.
+          pool         the pool to use, not owned; NULL to work on the calling thread
+          threshold    minimal number of bytes in one read to use the pool
+         */
+        void setWorkerPool(WorkerPool* pool, size_t threshold = PARALLEL_THRESHOLD);
     private:
         DES_KS ks_;
+        uint8_t iv_[8];
+        InputStream* stream_;
+        /** Position in stream_ of the first encrypted byte, after the header. */
+        size_t start_;
+        size_t length_;
+        bool length_known_;
+        size_t position_;
+        size_t stream_pos_;
+        error_t err_;
+        bool retain_;
+        WorkerPool* pool_;
+        size_t parallel_threshold_;
+        
+        void _SetError(error_t err) {
+            if (err_ == NoError) {
+                err_ = err;
+            }
+        }
+    };
+    
+    class OutputStreamDESCTR: public OutputStream
+    {
+    public:
+        /* s              the stream receiving the header and the ciphertext
+          iv              initial counter block; never reuse one with the same key
+          preferred_buffer_size  size in bytes of the buffer encrypted at once
+          retain          delete s together with this stream
+         */
+        OutputStreamDESCTR(OutputStream* s, const uint8_t iv[8], size_t preferred_buffer_size = 4096, bool retain = false);
+        virtual ~OutputStreamDESCTR();
+        
+        virtual size_t Write(const void* ptr, size_t size, size_t count);
+        virtual void Flush();
+        virtual void Seal();
+        virtual error_t Error() const { return err_; }
+        /* Lend the free part of the plaintext buffer; it is encrypted in place. */
+        virtual uint8_t* Reserve(size_t min, size_t* length);
+        virtual void Commit(size_t count);
+        
+        /* Set DES key.
+         key          64 bits key (only 56 bits used)
+         */
+        void setDESKey(const uint8_t key[8]);
+        
+        /* Generate the keystream of large flushes on a worker pool.
+          pool         the pool to use, not owned; NULL to work on the calling thread
+          threshold    minimal number of bytes in one flush to use the pool
+         */
+        void setWorkerPool(WorkerPool* pool, size_t threshold = PARALLEL_THRESHOLD);
     private:
+        DES_KS ks_;
+        uint8_t iv_[8];
         OutputStream* stream_;
         error_t err_;
         bool retain_;
         bool is_sealed_;
+        bool header_written_;
+        WorkerPool* pool_;
+        size_t parallel_threshold_;
         
         uint8_t* buffer_;
         size_t buffer_size_;
         size_t bytes_in_buffer_;
+        /** Number of bytes encrypted so far. */
+        uint64_t position_;
         
         void _SetError(error_t err) {
             if (err_ == NoError) {
                 err_ = err;
             }
         }
-        void _Flush(bool bSeal);
+        void _Flush();
+    };
+
+
+    /**
+     * CBC mode DES streams. Encryption chains every block into the next and
+     * stays serial, but decryption does not: each block is decrypted on its
+     * own and then XORed with the previous ciphertext block, so reads run
+     * on the bitsliced engine and the worker pool like ECB, and Seek() only
+     * costs one extra block.
+     *
+     * Format: the 8-byte IV in clear, then the ciphertext, padded as in
+     * PKCS#5 (1 to 8 bytes, each holding the padding length). The padding
+     * is read from the last block up front, so unlike the other input
+     * streams InputStreamDESCBC needs a stream that can seek.
+     */
+    class InputStreamDESCBC: public InputStreamDES
+    {
+    public:
+        /* s              the encrypted stream, positioned at the header
+          encrypted_bytes number of bytes after the header, -1 to read up to the end of s
+          retain          delete s together with this stream
+          window_size     size in bytes of the decrypted window that serves
+                          reads not covering whole blocks
+         */
+        InputStreamDESCBC(InputStream* s, size_t encrypted_bytes=-1, bool retain = false, size_t window_size = 4096);
+        
+        /* Set DES key. The padding is checked here, so the plain length
+          (and SEEK_END) is only known once the key is set.
+          key          64 bits key (only 56 bits used)
+         */
+        virtual void setDESKey(const uint8_t key[8]);
+    protected:
+        virtual size_t _ReadBlocks(size_t pos, uint8_t* dst, size_t count);
+    private:
+        uint8_t iv_[8];
+        /** Length of the ciphertext, padding included. */
+        size_t cipher_length_;
+        /** Ciphertext of the last block read, which chains into the block at chain_pos_. */
+        uint8_t chain_[8];
+        size_t chain_pos_;
+    };
+    
+    class OutputStreamDESCBC: public OutputStreamDES
+    {
+    public:
+        /* s              the stream receiving the header and the ciphertext;
+                          the header is written right away
+          iv              initial vector, should be unpredictable
+          preferred_buffer_size  size in bytes of the buffer flushed at once
+          retain          delete s together with this stream
+         */
+        OutputStreamDESCBC(OutputStream* s, const uint8_t iv[8], size_t preferred_buffer_size = 4096, bool retain = false);
+        // Seals here, while the chaining state is still reachable.
+        virtual ~OutputStreamDESCBC();
+        
+        // Adds the padding, then flushes everything.
+        virtual void Seal();
+    protected:
+        virtual void _Encrypt(uint8_t* data, size_t count);
+    private:
+        /** The last ciphertext block, the IV before the first one. */
+        uint8_t chain_[8];
     };
 
 } /* binary_coder */
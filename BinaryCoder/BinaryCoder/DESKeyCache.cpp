@@ -0,0 +1,92 @@
+//
+//  DESKeyCache.cpp
+//  BinaryCoder
+//
+
+#include "DESKeyCache.h"
+
+namespace binary_coder {
+
+    DESKeyCache::DESKeyCache(size_t capacity)
+    {
+        capacity_ = capacity;
+    }
+
+    void DESKeyCache::Schedule(DES_KS ks, const uint8_t key[8], int decrypt)
+    {
+        if (capacity_ == 0) {
+            deskey(ks, (unsigned char*)key, decrypt);
+            return;
+        }
+
+        // The parity bits (bit 0 of every byte) never reach the schedule,
+        // which leaves room for the direction in the identifier.
+        uint64_t id = 0;
+        for (int i = 0; i < 8; i++) {
+            id = (id << 8) | (key[i] & 0xfe);
+        }
+        id |= decrypt? 1: 0;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::unordered_map<uint64_t, EntryList::iterator>::iterator it = index_.find(id);
+            if (it != index_.end()) {
+                entries_.splice(entries_.begin(), entries_, it->second);
+                memcpy(ks, it->second->ks, sizeof(DES_KS));
+                return;
+            }
+        }
+
+        // Expand outside the lock; a concurrent miss on the same key only
+        // costs a duplicate expansion.
+        Entry entry;
+        entry.id = id;
+        deskey(entry.ks, (unsigned char*)key, decrypt);
+        memcpy(ks, entry.ks, sizeof(DES_KS));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (index_.find(id) != index_.end()) {
+            return;
+        }
+        entries_.push_front(entry);
+        index_[id] = entries_.begin();
+        if (entries_.size() > capacity_) {
+            index_.erase(entries_.back().id);
+            entries_.pop_back();
+        }
+    }
+
+    void DESKeyCache::Schedule3(DES3_KS ks, const uint8_t key[24], int decrypt)
+    {
+        // The stage layout of des3key().
+        if (!decrypt) {
+            Schedule(&ks[0], key, 0);
+            Schedule(&ks[16], key + 8, 1);
+            Schedule(&ks[32], key + 16, 0);
+        } else {
+            Schedule(&ks[32], key, 1);
+            Schedule(&ks[16], key + 8, 0);
+            Schedule(&ks[0], key + 16, 1);
+        }
+    }
+
+    size_t DESKeyCache::Size()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    void DESKeyCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+        index_.clear();
+    }
+
+    DESKeyCache& DESKeyCache::Shared()
+    {
+        static DESKeyCache cache;
+        return cache;
+    }
+
+} /* binary_coder */
@@ -0,0 +1,77 @@
+//
+//  DESKeyCache.h
+//  BinaryCoder
+//
+
+#ifndef BINARYCODER_DESKEYCACHE_H_
+#define BINARYCODER_DESKEYCACHE_H_
+
+#include "STDHeaders.h"
+#include "Constants.h"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+extern "C" {
+#include "des.h"
+}
+
+namespace binary_coder {
+
+    /**
+     * A bounded cache of DES key schedules, keyed by the key bytes and the
+     * direction. Looking up a key that was seen recently costs a hash
+     * lookup and a copy instead of a key expansion; when the cache is full
+     * the least recently used schedule is dropped.
+     *
+     * The parity bit of every key byte is ignored, as deskey() does, so
+     * keys differing only in parity share one entry. All methods are
+     * thread-safe.
+     */
+    class DESKeyCache
+    {
+    public:
+        /**
+         * @param capacity
+         *          Maximal number of schedules kept. 0 disables caching.
+         */
+        DESKeyCache(size_t capacity = KEY_CACHE_SIZE);
+
+        /**
+         * Copies the schedule of key into ks, expanding and caching it if
+         * needed. Same arguments as deskey().
+         */
+        void Schedule(DES_KS ks, const uint8_t key[8], int decrypt);
+        /**
+         * Same as des3key(), with each of the three stages looked up in
+         * the cache.
+         */
+        void Schedule3(DES3_KS ks, const uint8_t key[24], int decrypt);
+
+        size_t Size();
+        void Clear();
+
+        /** The cache used by the DES streams and DESWrapper. */
+        static DESKeyCache& Shared();
+
+    private:
+        struct Entry {
+            uint64_t id;
+            DES_KS ks;
+        };
+        typedef std::list<Entry> EntryList;
+
+        size_t capacity_;
+        std::mutex mutex_;
+        /** Most recently used first. */
+        EntryList entries_;
+        std::unordered_map<uint64_t, EntryList::iterator> index_;
+
+        DESKeyCache(const DESKeyCache&);
+        DESKeyCache& operator=(const DESKeyCache&);
+    };
+
+} /* binary_coder */
+
+#endif /* defined(BINARYCODER_DESKEYCACHE_H_) */
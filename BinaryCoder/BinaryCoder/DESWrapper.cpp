@@ -8,14 +8,26 @@
 
 #include "DESWrapper.h"
 #include "memory.h"
-extern "C" {
-#include "des.h"
+#include "CrypticStream.h"
+#include "DESKeyCache.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+/* Number of queued blocks from which they are processed, before the
+   schedules they use leave the cache. */
+#define BATCH_QUEUE_BLOCKS 1024
+
+DESWrapper::DESWrapper(binary_coder::WorkerPool* pool, unsigned long parallel_threshold)
+{
+    pool_ = pool;
+    parallel_threshold_ = parallel_threshold;
 }
 
 unsigned long DESWrapper::encrypt(const unsigned char key[8], const unsigned char* data, unsigned long num_bytes, unsigned char* output)
 {
     DES_KS ks;
-    deskey(ks, (unsigned char*)key, 0);
+    binary_coder::DESKeyCache::Shared().Schedule(ks, key, 0);
     
     memcpy(output, data, num_bytes);
     unsigned long l = ((num_bytes+7)>>3)<<3;
@@ -23,12 +35,7 @@ unsigned long DESWrapper::encrypt(const unsigned char key[8], const unsigned cha
         output[i] = 0;
     }
     
-    unsigned char* ptr = output;
-    unsigned char* end = output + l;
-    while (ptr < end) {
-        des(ks, ptr);
-        ptr += 8;
-    }
+    binary_coder::DESCryptECB(ks, output, l >> 3, pool_, parallel_threshold_);
     
     return l;
 }
@@ -36,17 +43,181 @@ unsigned long DESWrapper::encrypt(const unsigned char key[8], const unsigned cha
 unsigned long DESWrapper::decrypt(const unsigned char key[8], const unsigned char* data, unsigned long num_bytes, unsigned char* output)
 {
     DES_KS ks;
-    deskey(ks, (unsigned char*)key, 1);
+    binary_coder::DESKeyCache::Shared().Schedule(ks, key, 1);
     
     unsigned long l = num_bytes;
 //    assert((num_bytes & 0x07) == 0);
     memcpy(output, data, num_bytes);
-    unsigned char* ptr = output;
-    unsigned char* end = output + l;
-    while (ptr < end) {
-        des(ks, ptr);
-        ptr += 8;
+    binary_coder::DESCryptECB(ks, output, l >> 3, pool_, parallel_threshold_);
+    
+    return l;
+}
+
+unsigned long DESWrapper::encrypt3(const unsigned char key[24], const unsigned char* data, unsigned long num_bytes, unsigned char* output)
+{
+    DES3_KS ks;
+    binary_coder::DESKeyCache::Shared().Schedule3(ks, key, 0);
+    
+    memcpy(output, data, num_bytes);
+    unsigned long l = ((num_bytes+7)>>3)<<3;
+    for (unsigned long i=num_bytes; i<l; i++) {
+        output[i] = 0;
     }
     
+    binary_coder::DES3CryptECB(ks, output, l >> 3, pool_, parallel_threshold_);
+    
+    return l;
+}
+
+unsigned long DESWrapper::decrypt3(const unsigned char key[24], const unsigned char* data, unsigned long num_bytes, unsigned char* output)
+{
+    DES3_KS ks;
+    binary_coder::DESKeyCache::Shared().Schedule3(ks, key, 1);
+    
+    unsigned long l = num_bytes;
+    memcpy(output, data, num_bytes);
+    binary_coder::DES3CryptECB(ks, output, l >> 3, pool_, parallel_threshold_);
+    
     return l;
 }
+
+void DESWrapper::encryptBatch(Message* messages, size_t count)
+{
+    _cryptBatch(messages, count, 1, 0);
+}
+
+void DESWrapper::decryptBatch(Message* messages, size_t count)
+{
+    _cryptBatch(messages, count, 1, 1);
+}
+
+void DESWrapper::encrypt3Batch(Message* messages, size_t count)
+{
+    _cryptBatch(messages, count, 3, 0);
+}
+
+void DESWrapper::decrypt3Batch(Message* messages, size_t count)
+{
+    _cryptBatch(messages, count, 3, 1);
+}
+
+void DESWrapper::_cryptBatch(Message* messages, size_t count, int stages, int decrypt)
+{
+    const size_t key_bytes = 8 * stages;
+    const size_t ks_words = 32 * stages;
+    
+    // Copy and pad every message into its output, then sort them by key.
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++) {
+        Message& m = messages[i];
+        memmove(m.output, m.data, m.num_bytes);
+        if (decrypt) {
+            m.output_bytes = m.num_bytes;
+        } else {
+            m.output_bytes = ((m.num_bytes+7)>>3)<<3;
+            memset(m.output + m.num_bytes, 0, m.output_bytes - m.num_bytes);
+        }
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return memcmp(messages[a].key, messages[b].key, key_bytes) < 0;
+    });
+    
+    size_t groups = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i == 0 || memcmp(messages[order[i-1]].key, messages[order[i]].key, key_bytes) != 0) {
+            groups++;
+        }
+    }
+    std::vector<uint32_t> schedules(groups * ks_words);
+    
+    // Below desbs_width() blocks per key, or without SIMD slices, des4()
+    // beats the bitsliced engine; those blocks are queued with their
+    // schedule and done at the end.
+    const size_t width = desbs_width();
+    std::vector<uint32_t (*)[2]> queue_ks;
+    std::vector<unsigned char*> queue_blocks;
+    std::vector<unsigned char> scratch;
+    auto flush = [&]() {
+        binary_coder::ParallelRanges(pool_, queue_blocks.size(), 4, parallel_threshold_ >> 3, [&](size_t begin, size_t end) {
+            for (; begin + 4 <= end; begin += 4) {
+                des4(&queue_ks[begin], stages, &queue_blocks[begin]);
+            }
+            for (; begin < end; begin++) {
+                if (stages == 1) {
+                    des(queue_ks[begin], queue_blocks[begin]);
+                } else {
+                    des3(queue_ks[begin], queue_blocks[begin]);
+                }
+            }
+        });
+        queue_ks.clear();
+        queue_blocks.clear();
+    };
+    
+    size_t group = 0;
+    for (size_t first = 0; first < count; group++) {
+        size_t last = first + 1;
+        size_t blocks = messages[order[first]].output_bytes >> 3;
+        while (last < count && memcmp(messages[order[first]].key, messages[order[last]].key, key_bytes) == 0) {
+            blocks += messages[order[last]].output_bytes >> 3;
+            last++;
+        }
+        
+        uint32_t (*ks)[2] = (uint32_t (*)[2])&schedules[group * ks_words];
+        if (stages == 1) {
+            binary_coder::DESKeyCache::Shared().Schedule(ks, messages[order[first]].key, decrypt);
+        } else {
+            binary_coder::DESKeyCache::Shared().Schedule3(ks, messages[order[first]].key, decrypt);
+        }
+        
+        size_t full = width > 64 ? blocks - blocks % width : 0;
+        if (full > 0) {
+            unsigned char* data;
+            if (last == first + 1) {
+                data = messages[order[first]].output;
+            } else {
+                scratch.resize(full << 3);
+                data = &scratch[0];
+                size_t k = 0;
+                for (size_t i = first; i < last && k < full; i++) {
+                    size_t n = std::min<size_t>(messages[order[i]].output_bytes >> 3, full - k);
+                    memcpy(data + (k << 3), messages[order[i]].output, n << 3);
+                    k += n;
+                }
+            }
+            if (stages == 1) {
+                binary_coder::DESCryptECB(ks, data, full, pool_, parallel_threshold_);
+            } else {
+                binary_coder::DES3CryptECB(ks, data, full, pool_, parallel_threshold_);
+            }
+            if (last != first + 1) {
+                size_t k = 0;
+                for (size_t i = first; i < last && k < full; i++) {
+                    size_t n = std::min<size_t>(messages[order[i]].output_bytes >> 3, full - k);
+                    memcpy(messages[order[i]].output, data + (k << 3), n << 3);
+                    k += n;
+                }
+            }
+        }
+        
+        size_t k = 0;
+        for (size_t i = first; i < last; i++) {
+            Message& m = messages[order[i]];
+            size_t n = m.output_bytes >> 3;
+            size_t b = k < full ? std::min(n, full - k) : 0;
+            for (; b < n; b++) {
+                queue_ks.push_back(ks);
+                queue_blocks.push_back(m.output + (b << 3));
+            }
+            k += n;
+        }
+        // Flush while the schedules are still in cache.
+        if (queue_blocks.size() >= BATCH_QUEUE_BLOCKS) {
+            flush();
+        }
+        first = last;
+    }
+    
+    flush();
+}
@@ -9,9 +9,23 @@
 #ifndef __BinaryCoder__DESWrapper__
 #define __BinaryCoder__DESWrapper__
 
+#include "Constants.h"
+
+namespace binary_coder {
+    class WorkerPool;
+}
+
+/* Key schedules come from binary_coder::DESKeyCache::Shared(), so a
+   repeated key is not expanded again.
+ */
 class DESWrapper
 {
 public:
+    /* pool         worker pool for large buffers, not owned; NULL to run on the calling thread
+       parallel_threshold   minimal byte length of a buffer to split it over the pool
+     */
+    DESWrapper(binary_coder::WorkerPool* pool = NULL, unsigned long parallel_threshold = PARALLEL_THRESHOLD);
+    
     /* Encrypt data
        key          64 bits key (only 56 bits used)
        data         input data
@@ -28,6 +42,48 @@ public:
        return   the length of output data
      */
     unsigned long decrypt(const unsigned char key[8], const unsigned char* data, unsigned long num_bytes, unsigned char* output);
+    
+    /* Encrypt data with triple DES (EDE3)
+       key          K1, K2 and K3, 64 bits each (only 56 bits used)
+       others are the same as encrypt()
+     */
+    unsigned long encrypt3(const unsigned char key[24], const unsigned char* data, unsigned long num_bytes, unsigned char* output);
+    /* Decrypt data with triple DES (EDE3)
+       key          K1, K2 and K3, 64 bits each (only 56 bits used)
+       others are the same as decrypt()
+     */
+    unsigned long decrypt3(const unsigned char key[24], const unsigned char* data, unsigned long num_bytes, unsigned char* output);
+    
+    /* One message of a batch
+       key          64 bits key, or K1, K2 and K3 for the triple DES calls
+       data, num_bytes, output  same as for encrypt()/decrypt(); output may be data itself
+       output_bytes set to the length of the output data
+     */
+    struct Message {
+        const unsigned char* key;
+        const unsigned char* data;
+        unsigned long num_bytes;
+        unsigned char* output;
+        unsigned long output_bytes;
+    };
+    
+    /* Encrypt or decrypt `count' messages, each with its own key, with the
+       same result as calling encrypt()/decrypt() on every one of them.
+       The blocks of messages sharing a key are gathered to fill the
+       bitsliced engine, and the rest are processed four keys at a time
+       (des4()), so many small messages cost little more per byte than one
+       large buffer.
+     */
+    void encryptBatch(Message* messages, size_t count);
+    void decryptBatch(Message* messages, size_t count);
+    void encrypt3Batch(Message* messages, size_t count);
+    void decrypt3Batch(Message* messages, size_t count);
+    
+private:
+    void _cryptBatch(Message* messages, size_t count, int stages, int decrypt);
+    
+    binary_coder::WorkerPool* pool_;
+    unsigned long parallel_threshold_;
 };
 
 #endif /* defined(__BinaryCoder__DESWrapper__) */
@@ -1,91 +1,77 @@
 #include "Decoder.h"
-#include "Stream.h"
 
 namespace binary_coder {
 
-Decoder::Decoder(InputStream* input)
+DecoderBase::DecoderBase(InputStream* input, size_t bufferSize)
 {
     input_ = input;
 
-    buffer_size_ = BUFFER_SIZE;
-    buffer_ = new uint8_t[buffer_size_];
+    if (bufferSize < MIN_BUFFER_SIZE) {
+        bufferSize = MIN_BUFFER_SIZE;
+    }
+    buffer_size_ = bufferSize;
+    min_buffer_size_ = bufferSize;
+    max_buffer_size_ = bufferSize;
+    sequential_refills_ = 0;
+    own_buffer_ = new uint8_t[buffer_size_];
+    own_capacity_ = buffer_size_;
+    window_limit_ = WINDOW_LIMIT;
+    buffer_ = own_buffer_;
+    stream_lends_ = true;
     buffered_bytes_ = 0;
     position_ = 0;
+    // A stream that cannot tell, such as a pipe, is taken to start here.
+    stream_position_ = (long)input_->Tell();
+    if (stream_position_ < 0) {
+        stream_position_ = 0;
+    }
     index_ = 0;
     offset_ = 0;
+    reservoir_ = 0;
+    reservoir_index_ = 0;
+    reservoir_bits_ = 0;
 
     //error_ = NoError;
     ResetError();
 }
 
-Decoder::~Decoder()
+DecoderBase::~DecoderBase()
 {
-    delete[] buffer_;
+    delete[] own_buffer_;
 }
 
-bool Decoder::_SetError(error_t err)
+bool DecoderBase::_SetError(error_t err)
 {
     if (error_ == NoError) {
         error_ = err;
+        reservoir_bits_ = 0;
         return true;
     } else {
         return false;
     }
 }
 
-void Decoder::_Fill()
-{
-    long diff = buffered_bytes_ - index_;
-    if (diff < 0) {
-        diff = 0;
-    }
-    position_ += index_;
-
-    if ((size_t)index_ < buffered_bytes_) {
-        for (int i = 0; i < diff; i++) {
-            buffer_[i] = buffer_[index_++];
-        }
-    }
-
-    long bytesRead = 0;
-    long bytesToRead = buffer_size_ - diff;
-
-    buffered_bytes_ = diff;
-    input_->Seek(position_ + buffered_bytes_, SEEK_SET);
-
-    while (bytesToRead > 0) {
-        bytesRead = input_->Read(buffer_ + buffered_bytes_, 1, bytesToRead);
-        if (bytesRead == 0) {
-            bytesToRead = 0;
-        } else {
-            buffered_bytes_ += bytesRead;
-            bytesToRead -= bytesRead;
-        }
-    }
-
-    index_ = 0;
-}
-
-void Decoder::_DiscardBuffer()
+void DecoderBase::_DiscardBuffer()
 {
     position_ += index_;
+    reservoir_bits_ = 0;
     index_ = 0;
     buffered_bytes_ = 0;
 }
 
-long Decoder::Mark()
+long DecoderBase::Mark()
 {
     long current = position_ + index_;
     locations_.push_back(current);
     return current;
 }
 
-void Decoder::Unmark()
+void DecoderBase::Unmark()
 {
     locations_.pop_back();
 }
 
-void Decoder::Reset()
+void DecoderBase::Reset()
 {
     long last;
     if (locations_.empty()) {
@@ -96,14 +82,14 @@ void Decoder::Reset()
 
     if (last < position_) {
         _DiscardBuffer();
-        index_ = last & 0x01ff;
-        position_ = last - index_;
+        position_ = last;
+        _Jumped();
     } else {
         index_ = last - position_;
     }
 }
 
-long Decoder::Check(long expected)
+long DecoderBase::Check(long expected)
 {
     long last;
     if (locations_.empty()) {
@@ -117,23 +103,28 @@ long Decoder::Check(long expected)
     return real - expected;
 }
 
-void Decoder::Skip(size_t count)
+void DecoderBase::Skip(size_t count)
 {
     if (count == 0) {
         return;
     }
 
-    if (index_ + count < buffered_bytes_) {
+    // Up to the next refill, or with a mark in the window, the bytes are
+    // read through by _Fill() rather than sought past, so that the read
+    // stays sequential and Reset() finds the bytes kept for the mark.
+    long pos = position_ + index_ + count;
+    bool near = pos <= position_ + (long)(buffered_bytes_ + buffer_size_);
+    if (index_ + count <= buffered_bytes_
+        || (buffer_ == own_buffer_ && (near || _WindowStart(pos) < pos))) {
         index_ += count;
     } else {
-        long pos = position_ + index_ + count;
         _DiscardBuffer();
-        index_ = pos & 0x01ff;
-        position_ = pos - index_;
+        position_ = pos;
+        _Jumped();
     }
 }
 
-void Decoder::SkipBits(size_t bitsCount)
+void DecoderBase::SkipBits(size_t bitsCount)
 {
     long current = position_ + index_;
     long pointer = (current << BYTES_TO_BITS) + offset_;
@@ -143,288 +134,87 @@ void Decoder::SkipBits(size_t bitsCount)
     offset_ = pointer & LOWEST3;
 }
 
-void Decoder::AlignToByte() {
+void DecoderBase::AlignToByte() {
     if (offset_ > 0) {
         index_ += 1;
         offset_ = 0;
     }
 }
 
-long Decoder::BytesRead() const {
+long DecoderBase::BytesRead() const {
     return (position_ + index_) - locations_.back();
 }
 
-uint32_t Decoder::_ScanBits(int numberOfBits, bool updatePointer)
+long DecoderBase::_WindowStart(long current) const
 {
-    if (error_ != NoError) {
-        return 0;
-    }
-    
-    long pointer = (index_ << BYTES_TO_BITS) + offset_;
-
-    if (pointer + numberOfBits > (buffered_bytes_ << BYTES_TO_BITS)) {
-        _Fill();
-        pointer = (index_ << BYTES_TO_BITS) + offset_;
-    }
-
-    uint32_t value = 0;
-
-    if (numberOfBits > 0) {
-        if (pointer + numberOfBits > (buffered_bytes_ << BYTES_TO_BITS)) {
-            _SetError(ArrayIndexOutOfBounds);
-            return 0;
-        }
-
-        // The bit order within bytes in the SWF file format is big-endian: 
-        // the most significant bit is stored first, and the least 
-        // significant bit is stored last.
-        for (int i = BITS_PER_INT; 
-            (i > 0)  && (index_ < buffer_size_); 
-            i -= BITS_PER_BYTE) {
-            value |= (buffer_[index_++] & BYTE_MASK) << (i - BITS_PER_BYTE);
-        }
-
-        value <<= offset_;
-
-        if (updatePointer) {
-            pointer += numberOfBits;
+    long start = current;
+    long limit = current - (long)window_limit_;
+    std::list<long>::const_iterator it;
+    for (it = locations_.begin(); it != locations_.end(); ++it) {
+        if (*it < start && *it >= position_ && *it >= limit) {
+            start = *it;
         }
-        
-        index_ = pointer >> BITS_TO_BYTES;
-        offset_ = pointer & LOWEST3;
     }
-
-    return value;
-}
-
-int32_t Decoder::ReadSignedBits(int numberOfBits) {
-    int32_t value = (int32_t)_ScanBits(numberOfBits, true);
-    value >>= (BITS_PER_INT - numberOfBits);
-    return value;
+    return start;
 }
 
-uint32_t Decoder::ReadUnsignedBits(int numberOfBits) {
-    uint32_t value = _ScanBits(numberOfBits, true);
-    value >>= (BITS_PER_INT - numberOfBits);
-    return value;
-}
-
-int32_t Decoder::ScanSignedBits( int numberOfBits )
+void DecoderBase::_ResizeBuffer(size_t capacity)
 {
-    int32_t value = (int32_t)_ScanBits(numberOfBits, false);
-    value >>= (BITS_PER_INT - numberOfBits);
-    return value;
-}
-
-uint32_t Decoder::ScanUnsignedBits(int numberOfBits) {
-    uint32_t value = _ScanBits(numberOfBits, false);
-    value >>= (BITS_PER_INT - numberOfBits);
-    return value;
-}
-
-uint8_t Decoder::_ScanByte(bool updatePointer) {
-    if (error_ != NoError) {
-        return 0;
-    }
-    
-    if (index_ + 1 > buffered_bytes_) {
-        _Fill();
+    uint8_t* resized = new uint8_t[capacity];
+    if (buffer_ == own_buffer_) {
+        memcpy(resized, own_buffer_, buffered_bytes_);
+        buffer_ = resized;
     }
-
-    if (index_ + 1 > buffered_bytes_) {
-        _SetError(ArrayIndexOutOfBounds);
-        return 0;
-    }
-
-    uint8_t value = buffer_[index_] & BYTE_MASK;
-    if (updatePointer) {
-        index_++;
-    }
-    return value;
-}
-
-uint16_t Decoder::_ScanShort(bool updatePointer) {
-    if (error_ != NoError) {
-        return 0;
-    }
-    
-    if (index_ + 2 > buffered_bytes_) {
-        _Fill();
-    }
-
-    if (index_ + 2 > buffered_bytes_) {
-        _SetError(ArrayIndexOutOfBounds);
-        return 0;
-    }
-
-    uint16_t value = buffer_[index_] & BYTE_MASK;
-    value |= (buffer_[index_ + 1] & BYTE_MASK) << TO_BYTE1;
-    if (updatePointer) {
-        index_ += 2;
-    }
-    return value;
+    delete[] own_buffer_;
+    own_buffer_ = resized;
+    own_capacity_ = capacity;
 }
 
-uint32_t Decoder::_ScanInt(bool updatePointer) {
-    if (error_ != NoError) {
-        return 0;
-    }
-    
-    if (index_ + 4 > buffered_bytes_) {
-        _Fill();
+void DecoderBase::SetAdaptiveBuffer(size_t minimum, size_t maximum)
+{
+    if (minimum < MIN_BUFFER_SIZE) {
+        minimum = MIN_BUFFER_SIZE;
     }
-
-    if (index_ + 4 > buffered_bytes_) {
-        _SetError(ArrayIndexOutOfBounds);
-        return 0;
+    if (maximum < minimum) {
+        maximum = minimum;
     }
-
-    uint32_t value = buffer_[index_] & BYTE_MASK;
-    value |= (buffer_[index_ + 1] & BYTE_MASK) << TO_BYTE1;
-    value |= (buffer_[index_ + 2] & BYTE_MASK) << TO_BYTE2;
-    value |= (buffer_[index_ + 3] & BYTE_MASK) << TO_BYTE3;
-    if (updatePointer) {
-        index_ += 4;
+    min_buffer_size_ = minimum;
+    max_buffer_size_ = maximum;
+    if (buffer_size_ < minimum) {
+        buffer_size_ = minimum;
+    } else if (buffer_size_ > maximum) {
+        buffer_size_ = maximum;
     }
-    return value;
-}
-
-uint8_t Decoder::ScanUnsignedByte()
-{
-    return _ScanByte(false);
-}
-
-uint8_t Decoder::ReadUnsignedByte()
-{
-    return _ScanByte(true);
-}
-
-int8_t Decoder::ScanSignedByte()
-{
-    return (int8_t)_ScanByte(false);
-}
-
-int8_t Decoder::ReadSignedByte()
-{
-    return (int8_t)_ScanByte(true);
+    sequential_refills_ = 0;
 }
 
-uint16_t Decoder::ScanUnsignedShort()
+void DecoderBase::_Sequential()
 {
-    return _ScanShort(false);
-}
-
-uint16_t Decoder::ReadUnsignedShort()
-{
-    return _ScanShort(true);
-}
-
-int16_t Decoder::ScanSignedShort()
-{
-    return (int16_t)_ScanShort(false);
-}
-
-int16_t Decoder::ReadSignedShort()
-{
-    return (int16_t)_ScanShort(true);
-}
-
-uint32_t Decoder::ScanUnsignedInt()
-{
-    return _ScanInt(false);
-}
-
-uint32_t Decoder::ReadUnsignedInt()
-{
-    return _ScanInt(true);
-}
-
-int32_t Decoder::ScanSignedInt()
-{
-    return (int32_t)_ScanInt(false);
-}
-
-int32_t Decoder::ReadSignedInt()
-{
-    return (int32_t)_ScanInt(true);
-}
-
-size_t Decoder::ReadBytes(uint8_t* bytes, size_t wanted) {
-    long dest = 0;
-    long read = 0;
-    long available;
-    long remaining;
-    
-    if (error_ != NoError) {
-        return 0;
-    }
-
-    while (read < wanted) {
-        if (index_ >= buffered_bytes_) {
-            _Fill();
-        }
-        available = buffered_bytes_ - index_;
-        if (available <= 0) {
-            _SetError(ReachedEndOfFile);
-            break;
-        }
-        remaining = wanted - read;
-        if (available > remaining) {
-            available = remaining;
-        }
-        memcpy(bytes + dest, buffer_ + index_, available);
-        read += available;
-        index_ += available;
-        dest += available;
+    if (buffer_size_ >= max_buffer_size_ || ++sequential_refills_ < GROW_AFTER_REFILLS) {
+        return;
     }
-
-    return read;
-}
-
-string& Decoder::ReadString(string& out, int length) {
-    char* bytes = new char[length];
-    size_t read = ReadBytes((uint8_t*)bytes, length);
-    if (bytes[read - 1] == 0) {
-        read = read - 1;
+    sequential_refills_ = 0;
+    buffer_size_ *= 2;
+    if (buffer_size_ > max_buffer_size_) {
+        buffer_size_ = max_buffer_size_;
     }
-    out.append(bytes, read);
-    delete[] bytes;
-    return out;
 }
 
-string& Decoder::ReadString(string& out)
+void DecoderBase::_Jumped()
 {
-    if (error_ != NoError) {
-        return out;
+    sequential_refills_ = 0;
+    if (min_buffer_size_ == max_buffer_size_) {
+        return;
     }
-    
-    long start = index_;
-    //long length = 0;
-    long available;
-    bool finished = false;
-    long count;
-
-    while (!finished) {
-        available = buffered_bytes_ - index_;
-        if (available == 0) {
-            _Fill();
-            available = buffered_bytes_ - index_;
-        }
-        start = index_;
-        count = 0;
-        for (int i = 0; i < available; i++) {
-            if (buffer_[index_++] == 0) {
-                finished = true;
-                break;
-            } else {
-                count++;
-            }
-        }
-        out.append((const char*)(buffer_ + start), count);
-        //length += count;
+    buffer_size_ /= 2;
+    if (buffer_size_ < min_buffer_size_) {
+        buffer_size_ = min_buffer_size_;
+    }
+    // The buffer is empty now, so memory taken by a larger read size, or
+    // by marks, is given back.
+    if (own_capacity_ > 2 * buffer_size_) {
+        _ResizeBuffer(buffer_size_);
     }
-
-    return out;
 }
 
 } /* binary_coder */
@@ -3,16 +3,22 @@
 
 #include "STDHeaders.h"
 #include "Constants.h"
+#include "ByteOrder.h"
+#include "BitPack.h"
+#include "ByteScan.h"
+#include "Stream.h"
 
 namespace binary_coder {
 
-class InputStream;
-
-class Decoder
+/**
+ * The buffer state and positioning of a decoder. Reading from the stream,
+ * and everything that depends on the byte order of integers or the bit
+ * order of bit fields, is in BasicDecoder.
+ */
+class DecoderBase
 {
 public:
-    Decoder(InputStream* input);
-    ~Decoder();
+    ~DecoderBase();
 
     error_t GetLastError() const {
         return error_;
@@ -69,13 +75,129 @@ public:
      */
     long BytesRead() const;
 
+    /**
+     * Set how many bytes behind the read position are kept in the buffer
+     * for marks, so that Reset() to a mark at most that far back does not
+     * read the stream again. The buffer only grows while marks need it.
+     * @param limit the number of bytes, WINDOW_LIMIT by default.
+     */
+    void SetWindowLimit(size_t limit) {
+        window_limit_ = limit;
+    }
+
+    /**
+     * Let the read size follow the access pattern: it doubles, up to
+     * maximum, after GROW_AFTER_REFILLS refills in a row, and halves,
+     * down to minimum, whenever Skip() or Reset() throws buffered bytes
+     * away. A Skip() that ends within the next refill reads through and
+     * counts as sequential. Sequential decoding then makes few large reads
+     * and random access few wasted ones. The buffer size given to the constructor is
+     * where it starts.
+     * @param minimum the smallest read size, at least MIN_BUFFER_SIZE.
+     * @param maximum the largest read size.
+     */
+    void SetAdaptiveBuffer(size_t minimum, size_t maximum = MAX_BUFFER_SIZE);
+
+protected:
+    /**
+     * @param bufferSize the number of bytes read from the stream at a
+     *        time, at least MIN_BUFFER_SIZE.
+     */
+    DecoderBase(InputStream* input, size_t bufferSize);
+
+    bool _SetError(error_t err);
+    void _DiscardBuffer();
+    /**
+     * The position of the first byte to keep on the next refill: the
+     * oldest mark still in the buffer and within the window limit, or
+     * current if there is none.
+     */
+    long _WindowStart(long current) const;
+    /**
+     * Reallocates own_buffer_ with capacity bytes, keeping its contents,
+     * which must fit.
+     */
+    void _ResizeBuffer(size_t capacity);
+    /** Adapts buffer_size_ to a refill that follows the last one. */
+    void _Sequential();
+    /** Adapts buffer_size_ to a jump that dropped the buffer. */
+    void _Jumped();
+protected:
+    InputStream* input_;
+    /** The number of bytes read from the stream at a time. */
+    size_t buffer_size_;
+    /** The range of buffer_size_, a single value unless adaptive. */
+    size_t min_buffer_size_;
+    size_t max_buffer_size_;
+    /** Refills since the last jump or growth. */
+    int sequential_refills_;
+    /** pointer to the bytes being decoded, own_buffer_ or a view lent by the stream. */
+    const uint8_t* buffer_;
+    /** buffer for streams that cannot lend their data. */
+    uint8_t* own_buffer_;
+    /** The size of own_buffer_, more than buffer_size_ while marks keep bytes in it. */
+    size_t own_capacity_;
+    /** See SetWindowLimit(). */
+    size_t window_limit_;
+    /** Whether the stream lends its data (see InputStream::Lend()). */
+    bool stream_lends_;
+    /** The position of the buffer relative to the start of the file. */
+    long position_;
+    /** Where the stream is, so it is only sought on a real jump. */
+    long stream_position_;
+    /** The position from the start of the buffer. */
+    long index_;
+    /** The number of bytes available in the current buffer. */
+    size_t buffered_bytes_;
+    /** The offset in bits in the current buffer location. */
+    int offset_;
+    /**
+     * The 8 bytes of the buffer from reservoir_index_ on, loaded so that
+     * bit fields are read with shifts (see MSBFirst and LSBFirst).
+     */
+    uint64_t reservoir_;
+    long reservoir_index_;
+    /** The number of valid bits in reservoir_, 0 if it is stale. */
+    long reservoir_bits_;
+    /** Stack for storing file locations. */
+    std::list<long> locations_;
+
+    error_t error_;
+
+private:
+    DecoderBase(const DecoderBase&);
+    DecoderBase& operator=(const DecoderBase&);
+};
+
+/**
+ * A decoder for one byte order of multi-byte integers (LittleEndian or
+ * BigEndian) and one bit order of bit fields (MSBFirst or LSBFirst), see
+ * ByteOrder.h. The orders are fixed at compile time, so every read is
+ * straight-line code.
+ *
+ * Input is the type of the stream. The default, InputStream, takes any
+ * stream and refills through virtual calls; a final stream class such as
+ * InputMemoryBlock or InputMappedFile has its methods called directly.
+ * All of it is in this header, so the readers of bytes, shorts and ints
+ * inline into the caller and only a refill costs a call. To read the
+ * next block while decoding the current one, wrap the stream in an
+ * InputReadAhead (see ReadAheadStream.h).
+ */
+template <class ByteOrder, class BitOrder, class Input = InputStream>
+class BasicDecoder: public DecoderBase
+{
+public:
+    BasicDecoder(Input* input, size_t bufferSize = BUFFER_SIZE): DecoderBase(input, bufferSize) {}
+
     /**
      * Read a bit field and return the signed value.
      * @param numberOfBits
      *            the number of bits to read.
      * @return the value read.
      */
-    int32_t ReadSignedBits(int numberOfBits);
+    int32_t ReadSignedBits(int numberOfBits) {
+        return (int32_t)_SignExtend(_ScanBits(numberOfBits, true), numberOfBits);
+    }
 
     /**
      * Read a bit field and return the unsigned value.
@@ -83,7 +205,43 @@ public:
      *            the number of bits to read.
      * @return the value read.
      */
-    uint32_t ReadUnsignedBits(int numberOfBits);
+    uint32_t ReadUnsignedBits(int numberOfBits) {
+        return (uint32_t)_ScanBits(numberOfBits, true);
+    }
+
+    /**
+     * Read a bit field of up to 64 bits and return the signed value.
+     * @param numberOfBits
+     *            the number of bits to read.
+     * @return the value read.
+     */
+    int64_t ReadSignedBits64(int numberOfBits) {
+        return _SignExtend(_ScanBits(numberOfBits, true), numberOfBits);
+    }
+
+    /**
+     * Read a bit field of up to 64 bits and return the unsigned value.
+     * @param numberOfBits
+     *            the number of bits to read.
+     * @return the value read.
+     */
+    uint64_t ReadUnsignedBits64(int numberOfBits) {
+        return _ScanBits(numberOfBits, true);
+    }
+
+    /**
+     * Read count unsigned bit fields of the same width, as count calls to
+     * ReadUnsignedBits() would, but unpacked a buffer at a time (see
+     * UnpackBits()).
+     * @param values
+     *            receives the values.
+     * @param count
+     *            the number of fields.
+     * @param numberOfBits
+     *            the width of every field, 1 to 32.
+     * @return the number of fields read.
+     */
+    size_t ReadPackedBits(uint32_t* values, size_t count, int numberOfBits);
 
     /**
      * Read-ahead a bit field and return the signed value.
@@ -91,7 +249,9 @@ public:
      *            the number of bits to read.
      * @return the value read.
      */
-    int32_t ScanSignedBits(int numberOfBits);
+    int32_t ScanSignedBits(int numberOfBits) {
+        return (int32_t)_SignExtend(_ScanBits(numberOfBits, false), numberOfBits);
+    }
 
     /**
      * Read-ahead a bit field and return the unsigned value.
@@ -99,22 +259,40 @@ public:
      *            the number of bits to read.
      * @return the value read.
      */
-    uint32_t ScanUnsignedBits(int numberOfBits);
+    uint32_t ScanUnsignedBits(int numberOfBits) {
+        return (uint32_t)_ScanBits(numberOfBits, false);
+    }
 
-    uint8_t ScanUnsignedByte();
-    uint8_t ReadUnsignedByte();
-    int8_t ScanSignedByte();
-    int8_t ReadSignedByte();
+    uint8_t ScanUnsignedByte() { return _ScanByte(false); }
+    uint8_t ReadUnsignedByte() { return _ScanByte(true); }
+    int8_t ScanSignedByte() { return (int8_t)_ScanByte(false); }
+    int8_t ReadSignedByte() { return (int8_t)_ScanByte(true); }
 
-    uint16_t ScanUnsignedShort();
-    uint16_t ReadUnsignedShort();
-    int16_t ScanSignedShort();
-    int16_t ReadSignedShort();
+    uint16_t ScanUnsignedShort() { return _ScanShort(false); }
+    uint16_t ReadUnsignedShort() { return _ScanShort(true); }
+    int16_t ScanSignedShort() { return (int16_t)_ScanShort(false); }
+    int16_t ReadSignedShort() { return (int16_t)_ScanShort(true); }
 
-    uint32_t ScanUnsignedInt();
-    uint32_t ReadUnsignedInt();
-    int32_t ScanSignedInt();
-    int32_t ReadSignedInt();
+    uint32_t ScanUnsignedInt() { return _ScanInt(false); }
+    uint32_t ReadUnsignedInt() { return _ScanInt(true); }
+    int32_t ScanSignedInt() { return (int32_t)_ScanInt(false); }
+    int32_t ReadSignedInt() { return (int32_t)_ScanInt(true); }
+
+    /**
+     * Read an array of 16-bit, 32-bit or floating point values, stored
+     * like ReadUnsignedShort() and ReadUnsignedInt() store them. The
+     * whole array is copied at once instead of element by element.
+     * @param values
+     *            receives the values.
+     * @param count
+     *            the number of values to read.
+     * @return the number of values read.
+     */
+    size_t ReadUnsignedShorts(uint16_t* values, size_t count) { return _ReadArray(values, sizeof(*values), count); }
+    size_t ReadSignedShorts(int16_t* values, size_t count) { return _ReadArray(values, sizeof(*values), count); }
+    size_t ReadUnsignedInts(uint32_t* values, size_t count) { return _ReadArray(values, sizeof(*values), count); }
+    size_t ReadSignedInts(int32_t* values, size_t count) { return _ReadArray(values, sizeof(*values), count); }
+    size_t ReadFloats(float* values, size_t count) { return _ReadArray(values, sizeof(*values), count); }
 
     /**
      * Reads an array of bytes.
@@ -147,45 +325,510 @@ public:
     string& ReadString(string& out);
 
 private:
-    bool _SetError(error_t err);
-    void _DiscardBuffer();
-    void _Fill();
+    Input* _Stream() const {
+        return static_cast<Input*>(input_);
+    }
     /**
-     * Read a bit field. The first bit is stored in the the most significant
-     * bit of uint32_t. For example, if you read 10 bits of value 1011011111, 
-     * the return value is 10110111 11xxxxxx xxxxxxxx xxxxxxxx, where x is 
-     * undefined.
+     * Refills the buffer until it holds count bytes from index_ on, or the
+     * stream ends.
+     */
+    void _Fill(size_t count = 1);
+    /**
+     * Moves the stream to pos, only if it is somewhere else. A stream
+     * that cannot seek is read up to pos instead.
+     * @return false if the stream cannot get to pos.
+     */
+    bool _SeekStream(long pos);
+    /**
+     * Makes sure the buffer holds count more bytes, refilling it if not.
+     * @return false, with an error set, if there are not that many left.
+     */
+    bool _Require(size_t count) {
+        if (index_ + count <= buffered_bytes_ && error_ == NoError) {
+            return true;
+        }
+        return _FillAndRequire(count);
+    }
+    bool _FillAndRequire(size_t count);
+    /**
+     * Makes sure the buffer holds numberOfBits more bits, refilling it if
+     * not.
+     * @return false, with an error set, if there are not that many left.
+     */
+    bool _RequireBits(int numberOfBits);
+
+    uint8_t _ScanByte(bool updatePointer);
+    /**
+     * Read a bit field of up to 64 bits.
      * @param numberOfBits
      *            the number of bits to read.
      * @param updatePointer
      *            indicates whether to advance the internal pointer.
-     * @return the bits read.
+     * @return the bits read, in the low numberOfBits bits.
      */
-    uint32_t _ScanBits(int numberOfBits, bool updatePointer);
-    
-    uint8_t _ScanByte(bool updatePointer);
+    uint64_t _ScanBits(int numberOfBits, bool updatePointer);
+    /** _ScanBits() when the field is not all in reservoir_. */
+    uint64_t _LoadAndScanBits(int numberOfBits, bool updatePointer);
+    /** The numberOfBits bits at bit shift of a reservoir. */
+    static uint64_t _Extract(uint64_t reservoir, unsigned long shift, int numberOfBits);
+    static int64_t _SignExtend(uint64_t value, int numberOfBits) {
+        return numberOfBits > 0 ? (int64_t)(value << (64 - numberOfBits)) >> (64 - numberOfBits) : 0;
+    }
+
     uint16_t _ScanShort(bool updatePointer);
     uint32_t _ScanInt(bool updatePointer);
-private:
-    InputStream* input_;
-    /** buffer size */
-    size_t buffer_size_;
-    /** pointer to buffer. */
-    uint8_t* buffer_;
-    /** The position of the buffer relative to the start of the file. */
-    long position_;
-    /** The position from the start of the buffer. */
-    long index_;
-    /** The number of bytes available in the current buffer. */
-    size_t buffered_bytes_;
-    /** The offset in bits in the current buffer location. */
-    int offset_;
-    /** Stack for storing file locations. */
-    std::list<long> locations_;
-
-    error_t error_;
+    /**
+     * Read count values of size bytes each into values.
+     * @return the number of values read.
+     */
+    size_t _ReadArray(void* values, size_t size, size_t count);
 };
 
+/** The SWF layout: little-endian integers, bit fields most significant bit first. */
+typedef BasicDecoder<LittleEndian, MSBFirst> Decoder;
+/** Network byte order integers. */
+typedef BasicDecoder<BigEndian, MSBFirst> BigEndianDecoder;
+
+// The readers are inline, so a field already in the reservoir costs a few
+// shifts and no call.
+template <class ByteOrder, class BitOrder, class Input>
+inline uint64_t BasicDecoder<ByteOrder, BitOrder, Input>::_Extract(uint64_t reservoir, unsigned long shift, int numberOfBits)
+{
+    if (BitOrder::MostSignificantFirst) {
+        return (reservoir << shift) >> (64 - numberOfBits);
+    } else {
+        return (reservoir >> shift) & (~(uint64_t)0 >> (64 - numberOfBits));
+    }
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+inline uint64_t BasicDecoder<ByteOrder, BitOrder, Input>::_ScanBits(int numberOfBits, bool updatePointer)
+{
+    // Successive fields come out of the same 8 bytes, until they run past
+    // them. The reservoir is emptied on errors, so this also stops there.
+    // A pointer moved back before the reservoir makes shift wrap around,
+    // so it is range checked on its own, together with numberOfBits.
+    long pointer = (index_ << BITS_TO_BYTES) + offset_;
+    unsigned long shift = (unsigned long)(pointer - (reservoir_index_ << BYTES_TO_BITS));
+    if ((shift | (unsigned long)(numberOfBits - 1)) >= 64 || shift + numberOfBits > (unsigned long)reservoir_bits_) {
+        return _LoadAndScanBits(numberOfBits, updatePointer);
+    }
+
+    if (updatePointer) {
+        pointer += numberOfBits;
+        index_ = pointer >> BITS_TO_BYTES;
+        offset_ = pointer & LOWEST3;
+    }
+    return _Extract(reservoir_, shift, numberOfBits);
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+uint64_t BasicDecoder<ByteOrder, BitOrder, Input>::_LoadAndScanBits(int numberOfBits, bool updatePointer)
+{
+    if (error_ != NoError || numberOfBits <= 0) {
+        return 0;
+    }
+    if (numberOfBits > 64) {
+        _SetError(BadArguments);
+        return 0;
+    }
+    if (!_RequireBits(numberOfBits)) {
+        return 0;
+    }
+
+    typedef typename BitOrder::WordOrder WordOrder;
+    size_t available = buffered_bytes_ - index_;
+    if (available >= sizeof(reservoir_)) {
+        reservoir_ = WordOrder::Load64(buffer_ + index_);
+        reservoir_bits_ = 64;
+    } else {
+        uint8_t word[sizeof(reservoir_)] = {0};
+        memcpy(word, buffer_ + index_, available);
+        reservoir_ = WordOrder::Load64(word);
+        reservoir_bits_ = available << BYTES_TO_BITS;
+    }
+    reservoir_index_ = index_;
+
+    uint64_t value;
+    if (offset_ + numberOfBits <= reservoir_bits_) {
+        value = _Extract(reservoir_, offset_, numberOfBits);
+    } else {
+        // Up to 7 bits of a 64-bit field are in the byte after the 8.
+        uint64_t next = buffer_[index_ + 8];
+        if (BitOrder::MostSignificantFirst) {
+            value = ((reservoir_ << offset_) | (next >> (BITS_PER_BYTE - offset_))) >> (64 - numberOfBits);
+        } else {
+            value = ((reservoir_ >> offset_) | (next << (64 - offset_))) & (~(uint64_t)0 >> (64 - numberOfBits));
+        }
+    }
+
+    if (updatePointer) {
+        long pointer = (index_ << BITS_TO_BYTES) + offset_ + numberOfBits;
+        index_ = pointer >> BITS_TO_BYTES;
+        offset_ = pointer & LOWEST3;
+    }
+    return value;
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+size_t BasicDecoder<ByteOrder, BitOrder, Input>::ReadPackedBits(uint32_t* values, size_t count, int numberOfBits)
+{
+    if (numberOfBits <= 0 || numberOfBits > BITS_PER_INT) {
+        _SetError(BadArguments);
+        return 0;
+    }
+
+    size_t read = 0;
+    while (read < count && error_ == NoError) {
+        long pointer = (index_ << BITS_TO_BYTES) + offset_;
+        long available = (long)(buffered_bytes_ << BYTES_TO_BITS) - pointer;
+        size_t n = available > 0 ? (size_t)available / numberOfBits : 0;
+        if (n > count - read) {
+            n = count - read;
+        }
+        if (n == 0) {
+            // The next field runs past the buffer; the scalar reader
+            // refills it.
+            uint32_t value = ReadUnsignedBits(numberOfBits);
+            if (error_ == NoError) {
+                values[read++] = value;
+            }
+            continue;
+        }
+        if (BitOrder::MostSignificantFirst) {
+            UnpackBits(buffer_ + index_, offset_, numberOfBits, values + read, n);
+        } else {
+            UnpackBitsLSB(buffer_ + index_, offset_, numberOfBits, values + read, n);
+        }
+        pointer += (long)(n * numberOfBits);
+        index_ = pointer >> BITS_TO_BYTES;
+        offset_ = pointer & LOWEST3;
+        read += n;
+    }
+    return read;
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+inline uint16_t BasicDecoder<ByteOrder, BitOrder, Input>::_ScanShort(bool updatePointer)
+{
+    if (!_Require(2)) {
+        return 0;
+    }
+    uint16_t value = ByteOrder::Load16(buffer_ + index_);
+    if (updatePointer) {
+        index_ += 2;
+    }
+    return value;
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+inline uint32_t BasicDecoder<ByteOrder, BitOrder, Input>::_ScanInt(bool updatePointer)
+{
+    if (!_Require(4)) {
+        return 0;
+    }
+    uint32_t value = ByteOrder::Load32(buffer_ + index_);
+    if (updatePointer) {
+        index_ += 4;
+    }
+    return value;
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+size_t BasicDecoder<ByteOrder, BitOrder, Input>::_ReadArray(void* values, size_t size, size_t count)
+{
+    size_t read = ReadBytes((uint8_t*)values, size * count) / size;
+    if (!ByteOrder::IsHost) {
+        SwapBytes((uint8_t*)values, size, read);
+    }
+    return read;
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+inline uint8_t BasicDecoder<ByteOrder, BitOrder, Input>::_ScanByte(bool updatePointer) {
+    if (!_Require(1)) {
+        return 0;
+    }
+
+    uint8_t value = buffer_[index_] & BYTE_MASK;
+    if (updatePointer) {
+        index_++;
+    }
+    return value;
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+void BasicDecoder<ByteOrder, BitOrder, Input>::_Fill(size_t count)
+{
+    long current = position_ + index_;
+    reservoir_bits_ = 0;
+
+    // Streams that can lend their data are decoded in place, without
+    // copying it into own_buffer_. The first view starts where the empty
+    // own_buffer_ does, not at bytes skipped to: a stream that cannot seek
+    // would drop the bytes in between, which a mark may still want.
+    if (stream_lends_) {
+        long at = buffer_ == own_buffer_ ? position_ : current;
+        size_t lent = 0;
+        const uint8_t* view = NULL;
+        if (_SeekStream(at)) {
+            view = _Stream()->Lend(&lent);
+        }
+        if (view == NULL) {
+            stream_lends_ = false;
+        } else {
+            // A view that ends within the count bytes is lent again from
+            // current, unless a mark wants the bytes before it.
+            if (at + (long)lent < current + (long)count && at < current
+                && _WindowStart(current) == current && _SeekStream(current)) {
+                at = current;
+                view = _Stream()->Lend(&lent);
+            }
+            if (view != NULL && at + (long)lent >= current + (long)count) {
+                buffer_ = view;
+                buffered_bytes_ = lent;
+                position_ = at;
+                index_ = current - at;
+                return;
+            }
+            // Still too short: the bytes are copied into own_buffer_.
+        }
+    }
+
+    if (buffer_ != own_buffer_) {
+        // Read the rest of the last view again.
+        buffer_ = own_buffer_;
+        buffered_bytes_ = 0;
+        position_ = current;
+        index_ = 0;
+    } else {
+        _Sequential();
+    }
+
+    // Bytes skipped past the end of the buffer (see Skip()) are read
+    // through, one read at a time, until the buffer holds count bytes
+    // from index_ on; a field may start just before the end of a read.
+    long bytesRead;
+    do {
+        // The unread bytes stay, and so do the bytes back to the oldest
+        // mark in the window, for Reset() to find them.
+        long start = _WindowStart(current) - position_;
+        if (start > (long)buffered_bytes_) {
+            start = (long)buffered_bytes_;
+        }
+
+        // Bytes are appended until there is no room left for a full read,
+        // then the ones kept are moved to the front, into a larger buffer
+        // if marks keep too many or the read size has grown.
+        if (own_capacity_ - buffered_bytes_ < buffer_size_) {
+            size_t kept = buffered_bytes_ - start;
+            if ((start < index_ || own_capacity_ < buffer_size_) && kept + buffer_size_ > own_capacity_) {
+                size_t capacity = own_capacity_ * 2;
+                if (capacity < kept + buffer_size_) {
+                    capacity = kept + buffer_size_;
+                }
+                _ResizeBuffer(capacity);
+            }
+            memmove(own_buffer_, own_buffer_ + start, kept);
+            position_ += start;
+            index_ -= start;
+            buffered_bytes_ = kept;
+        }
+
+        long bytesToRead = own_capacity_ - buffered_bytes_;
+        if (bytesToRead > (long)buffer_size_) {
+            bytesToRead = buffer_size_;
+        }
+
+        if (!_SeekStream(position_ + buffered_bytes_)) {
+            return;
+        }
+
+        bytesRead = 0;
+        while (bytesToRead > 0) {
+            long got = _Stream()->Read(own_buffer_ + buffered_bytes_, 1, bytesToRead);
+            if (got == 0) {
+                bytesToRead = 0;
+            } else {
+                buffered_bytes_ += got;
+                bytesToRead -= got;
+                bytesRead += got;
+                stream_position_ += got;
+            }
+        }
+    } while (bytesRead > 0 && index_ + count > buffered_bytes_);
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+bool BasicDecoder<ByteOrder, BitOrder, Input>::_SeekStream(long pos)
+{
+    if (pos == stream_position_) {
+        return true;
+    }
+    if (_Stream()->Seek(pos, SEEK_SET) == 0) {
+        stream_position_ = pos;
+        return true;
+    }
+    // Forward on a stream that cannot seek: read and drop the bytes in
+    // between, through the free end of own_buffer_.
+    long at = (long)_Stream()->Tell();
+    if (at >= 0) {
+        stream_position_ = at;
+    }
+    if (pos < stream_position_) {
+        _SetError(FailedToSeek);
+        return false;
+    }
+    size_t used = buffer_ == own_buffer_ ? buffered_bytes_ : 0;
+    size_t free = own_capacity_ - used;
+    while (pos > stream_position_) {
+        size_t n = (size_t)(pos - stream_position_);
+        if (n > free) {
+            n = free;
+        }
+        size_t read = _Stream()->Read(own_buffer_ + used, 1, n);
+        if (read == 0) {
+            return false;
+        }
+        stream_position_ += read;
+    }
+    return true;
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+bool BasicDecoder<ByteOrder, BitOrder, Input>::_FillAndRequire(size_t count)
+{
+    if (error_ != NoError) {
+        return false;
+    }
+    _Fill(count);
+    if (index_ + count > buffered_bytes_) {
+        _SetError(ArrayIndexOutOfBounds);
+        return false;
+    }
+    return true;
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+bool BasicDecoder<ByteOrder, BitOrder, Input>::_RequireBits(int numberOfBits)
+{
+    long pointer = (index_ << BITS_TO_BYTES) + offset_;
+    if (pointer + numberOfBits > (long)(buffered_bytes_ << BYTES_TO_BITS)) {
+        _Fill((offset_ + numberOfBits + LOWEST3) >> BITS_TO_BYTES);
+        pointer = (index_ << BITS_TO_BYTES) + offset_;
+        if (pointer + numberOfBits > (long)(buffered_bytes_ << BYTES_TO_BITS)) {
+            _SetError(ArrayIndexOutOfBounds);
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+size_t BasicDecoder<ByteOrder, BitOrder, Input>::ReadBytes(uint8_t* bytes, size_t wanted) {
+    long dest = 0;
+    long read = 0;
+    long available;
+    long remaining;
+    
+    if (error_ != NoError) {
+        return 0;
+    }
+
+    while ((size_t)read < wanted) {
+        remaining = wanted - read;
+        if ((size_t)index_ >= buffered_bytes_ && !stream_lends_ && remaining >= (long)buffer_size_
+            && _WindowStart(position_ + index_ + remaining) == position_ + index_ + remaining) {
+            // Too large to be worth a copy through the buffer, unless a
+            // mark keeps the bytes for Reset().
+            _DiscardBuffer();
+            if (!_SeekStream(position_)) {
+                break;
+            }
+            while ((size_t)read < wanted) {
+                long got = _Stream()->Read(bytes + read, 1, wanted - read);
+                if (got == 0) {
+                    _SetError(ReachedEndOfFile);
+                    break;
+                }
+                stream_position_ += got;
+                position_ += got;
+                read += got;
+            }
+            break;
+        }
+        if ((size_t)index_ >= buffered_bytes_) {
+            _Fill();
+        }
+        available = buffered_bytes_ - index_;
+        if (available <= 0) {
+            _SetError(ReachedEndOfFile);
+            break;
+        }
+        if (available > remaining) {
+            available = remaining;
+        }
+        memcpy(bytes + dest, buffer_ + index_, available);
+        read += available;
+        index_ += available;
+        dest += available;
+    }
+
+    return read;
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+string& BasicDecoder<ByteOrder, BitOrder, Input>::ReadString(string& out, int length) {
+    char* bytes = new char[length];
+    size_t read = ReadBytes((uint8_t*)bytes, length);
+    if (bytes[read - 1] == 0) {
+        read = read - 1;
+    }
+    out.append(bytes, read);
+    delete[] bytes;
+    return out;
+}
+
+template <class ByteOrder, class BitOrder, class Input>
+string& BasicDecoder<ByteOrder, BitOrder, Input>::ReadString(string& out)
+{
+    if (error_ != NoError) {
+        return out;
+    }
+    
+    long start = index_;
+    //long length = 0;
+    long available;
+    bool finished = false;
+    long count;
+
+    while (!finished) {
+        available = buffered_bytes_ - index_;
+        if (available <= 0) {
+            _Fill();
+            available = buffered_bytes_ - index_;
+            if (available <= 0) {
+                _SetError(ReachedEndOfFile);
+                break;
+            }
+        }
+        start = index_;
+        const uint8_t* end = FindByte(buffer_ + start, available, 0);
+        if (end != NULL) {
+            count = end - (buffer_ + start);
+            index_ += count + 1;
+            finished = true;
+        } else {
+            count = available;
+            index_ += count;
+        }
+        out.append((const char*)(buffer_ + start), count);
+        //length += count;
+    }
+
+    return out;
+}
+
 } /* binary_coder */
 
 #endif
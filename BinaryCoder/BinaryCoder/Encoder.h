@@ -11,20 +11,20 @@
 
 #include "STDHeaders.h"
 #include "Constants.h"
+#include "ByteOrder.h"
+#include "Stream.h"
 
 namespace binary_coder {
-    class OutputStream;
-    class Encoder
+
+    /**
+     * The buffer state and positioning of an encoder. Writing to the
+     * stream, and everything that depends on the byte order of integers or
+     * the bit order of bit fields, is in BasicEncoder.
+     */
+    class EncoderBase
     {
     public:
-        /**
-         * Create a new SWFEncoder for the underlying InputStream with the
-         * specified buffer size.
-         *
-         * @param streamOut the stream from which data will be written.
-         */
-        Encoder(OutputStream* streamOut);
-        ~Encoder();
+        ~EncoderBase();
         
         error_t GetLastError() const {
             return error_;
@@ -35,15 +35,96 @@ namespace binary_coder {
         }
         
         /**
-         * Remember the current position.
-         * @return the current position.
+         * Discard the last saved position.
          */
+        void Unmark();
+        
+    protected:
+        /**
+         * Create a new SWFEncoder for the underlying InputStream with the
+         * specified buffer size.
+         *
+         * @param streamOut the stream from which data will be written.
+         * @param bufferSize the size of own_buffer_, at least
+         *        MIN_BUFFER_SIZE; streams that reserve regions choose their
+         *        own size.
+         */
+        EncoderBase(OutputStream* streamOut, size_t bufferSize);
+        
+        // For BasicEncoder to call once the bit accumulator is drained.
         long Mark();
+        long Check(long expected);
+        void AlignToByte();
+        
+        bool _SetError(error_t err);
         
+    protected:
+        /** The underlying output stream. */
+        OutputStream* stream_;
+        /** buffer size */
+        size_t buffer_size_;
         /**
-         * Discard the last saved position.
+         * pointer to buffer: a region reserved in the stream (see
+         * OutputStream::Reserve()), so bytes are encoded in place, or
+         * own_buffer_ for streams that cannot lend one. NULL until the
+         * first write.
          */
-        void Unmark();
+        uint8_t* buffer_;
+        /** buffer for streams that cannot lend one. */
+        uint8_t* own_buffer_;
+        /** The size of own_buffer_. */
+        size_t own_size_;
+        /** The position of the buffer relative to the start of the stream. */
+        long position_;
+        /** The index in bytes to the current location in the buffer. */
+        long index_;
+        /** The offset in bits to the location in the current byte. */
+        int offset_;
+        /**
+         * Bits written but not stored yet, the first one in the most
+         * significant bit for MSBFirst, in the least significant bit for
+         * LSBFirst. They go at index_; a partly written byte is taken into
+         * it, so offset_ is 0 while bit_count_ is not.
+         */
+        uint64_t bits_;
+        /** The number of bits in bits_, less than 64. */
+        int bit_count_;
+        /** Stack for storing file locations. */
+        std::list<long> locations_;
+        
+        error_t error_;
+        
+    private:
+        EncoderBase(const EncoderBase&);
+        EncoderBase& operator=(const EncoderBase&);
+    };
+    
+    /**
+     * An encoder for one byte order of multi-byte integers (LittleEndian or
+     * BigEndian) and one bit order of bit fields (MSBFirst or LSBFirst), see
+     * ByteOrder.h. The orders are fixed at compile time, so every write is
+     * straight-line code.
+     *
+     * Output is the type of the stream. The default, OutputStream, takes
+     * any stream through virtual calls; a final stream class such as
+     * OutputFile has its methods called directly. All of it is in this
+     * header, so the writers of bytes, shorts and ints inline into the
+     * caller and only handing a full buffer to the stream costs a call.
+     */
+    template <class ByteOrder, class BitOrder, class Output = OutputStream>
+    class BasicEncoder: public EncoderBase
+    {
+    public:
+        BasicEncoder(Output* streamOut, size_t bufferSize = BUFFER_SIZE): EncoderBase(streamOut, bufferSize) {}
+        
+        /**
+         * Remember the current position.
+         * @return the current position.
+         */
+        long Mark() {
+            _DrainBits();
+            return EncoderBase::Mark();
+        }
         
         /**
          * Compare the number of bytes read with the expected number and throw an
@@ -52,18 +133,26 @@ namespace binary_coder {
          * @param expected the expected number of bytes read.
          * @return the differece between real and expected length.
          */
-        long Check(long expected);
+        long Check(long expected) {
+            _DrainBits();
+            return EncoderBase::Check(expected);
+        }
         
         /**
          * Changes the location to the next byte boundary.
          */
-        void AlignToByte();
+        void AlignToByte() {
+            _DrainBits();
+            EncoderBase::AlignToByte();
+        }
         
         /**
-         * Write the data currently stored in the buffer to the underlying stream.
+         * Write the data currently stored in the buffer to the underlying
+         * stream. A partly written byte is first padded with zero bits, as
+         * by AlignToByte().
          */
         void Flush();
-
+        
         /**
          * Write a value to bit field.
          *
@@ -73,8 +162,35 @@ namespace binary_coder {
          *            the (least significant) number of bits that will be written.
          * stream.
          */
-        void WriteBits(int value, int numberOfBits);
-
+        void WriteBits(int value, int numberOfBits) {
+            WriteBits64((int64_t)value, numberOfBits);
+        }
+        
+        /**
+         * Write a value of up to 64 bits to bit field.
+         *
+         * @param value
+         *            the value.
+         * @param numberOfBits
+         *            the (least significant) number of bits that will be written,
+         *            up to 64.
+         */
+        void WriteBits64(uint64_t value, int numberOfBits);
+        
+        /**
+         * Write count bit fields of the same width, as count calls to
+         * WriteBits() would.
+         *
+         * @param values
+         *            the values.
+         * @param count
+         *            the number of fields.
+         * @param numberOfBits
+         *            the (least significant) number of bits written from
+         *            every value, 1 to 32.
+         */
+        void WritePackedBits(const uint32_t* values, size_t count, int numberOfBits);
+        
         /**
          * Write a byte.
          *
@@ -82,7 +198,13 @@ namespace binary_coder {
          *            the value to be written - only the least significant byte will
          *            be written.
          */
-        void WriteByte(int value);
+        void WriteByte(int value) {
+            _DrainBits();
+            if (buffer_ == NULL || (size_t)index_ == buffer_size_) {
+                _Next(1);
+            }
+            buffer_[index_++] = (uint8_t) value;
+        }
         
         /**
          * Write an array of bytes.
@@ -100,7 +222,14 @@ namespace binary_coder {
          * @param value
          *            an integer containing the value to be written.
          */
-        void WriteShort(int value);
+        void WriteShort(int value) {
+            _DrainBits();
+            if (buffer_ == NULL || (size_t)index_ + 2 > buffer_size_) {
+                _Next(2);
+            }
+            ByteOrder::Store16(buffer_ + index_, (uint16_t)value);
+            index_ += 2;
+        }
         
         /**
          * Write a 32-bit integer.
@@ -108,7 +237,30 @@ namespace binary_coder {
          * @param value
          *            an integer containing the value to be written.
          */
-        void WriteInt(int value);
+        void WriteInt(int value) {
+            _DrainBits();
+            if (buffer_ == NULL || (size_t)index_ + 4 > buffer_size_) {
+                _Next(4);
+            }
+            ByteOrder::Store32(buffer_ + index_, (uint32_t)value);
+            index_ += 4;
+        }
+        
+        /**
+         * Write an array of 16-bit, 32-bit or floating point values, stored
+         * like WriteShort() and WriteInt() store them. The whole array is
+         * copied at once instead of element by element.
+         *
+         * @param values
+         *            the values to be written.
+         * @param count
+         *            the number of values.
+         */
+        void WriteShorts(const uint16_t* values, size_t count) { _WriteArray(values, sizeof(*values), count); }
+        void WriteShorts(const int16_t* values, size_t count) { _WriteArray(values, sizeof(*values), count); }
+        void WriteInts(const uint32_t* values, size_t count) { _WriteArray(values, sizeof(*values), count); }
+        void WriteInts(const int32_t* values, size_t count) { _WriteArray(values, sizeof(*values), count); }
+        void WriteFloats(const float* values, size_t count) { _WriteArray(values, sizeof(*values), count); }
         
         /**
          * Write a string using the default character set defined in the encoder.
@@ -116,29 +268,340 @@ namespace binary_coder {
          * @param str
          *            the string.
          */
-        void WriteString(const std::string str);
-
-    private:
-        bool _SetError(error_t err);
+        void WriteString(const std::string str) {
+            WriteBytes((const uint8_t*)str.c_str(), str.size());
+            WriteByte(0);
+        }
         
-    private:
-        /** The underlying output stream. */
-        OutputStream* stream_;
-        /** buffer size */
-        size_t buffer_size_;
-        /** pointer to buffer. */
-        uint8_t* buffer_;
-        /** The position of the buffer relative to the start of the stream. */
-        long position_;
-        /** The index in bytes to the current location in the buffer. */
-        long index_;
-        /** The offset in bits to the location in the current byte. */
-        int offset_;
-        /** Stack for storing file locations. */
-        std::list<long> locations_;
+        /**
+         * Write numOfBytes zero bytes as a placeholder for a field, such as
+         * a length or an offset, that is only known once what follows it
+         * is written. Fill it in with PatchShort(), PatchInt() or
+         * PatchBytes().
+         *
+         * @return the position of the placeholder.
+         */
+        long WritePlaceholder(size_t numOfBytes);
         
-        error_t error_;
+        /**
+         * Overwrite bytes already written, at a position returned by Mark()
+         * or WritePlaceholder(). Bytes still in the buffer are changed in
+         * place; bytes already handed to the stream are rewritten with
+         * OutputStream::Patch(), which fails with FailedToSeek on streams
+         * that cannot go back. The end of the output does not move.
+         *
+         * @param position
+         *            the position of the first byte.
+         * @param bytes
+         *            the new bytes.
+         */
+        void PatchBytes(long position, const uint8_t* bytes, size_t numOfBytes);
+        
+        /**
+         * Overwrite a 16-bit integer written before, as WriteShort() stores it.
+         */
+        void PatchShort(long position, int value) {
+            uint8_t bytes[2];
+            ByteOrder::Store16(bytes, (uint16_t)value);
+            PatchBytes(position, bytes, sizeof(bytes));
+        }
+        
+        /**
+         * Overwrite a 32-bit integer written before, as WriteInt() stores it.
+         */
+        void PatchInt(long position, int value) {
+            uint8_t bytes[4];
+            ByteOrder::Store32(bytes, (uint32_t)value);
+            PatchBytes(position, bytes, sizeof(bytes));
+        }
+        
+    private:
+        Output* _Stream() const {
+            return static_cast<Output*>(stream_);
+        }
+        /**
+         * Hands the complete bytes to the stream.
+         */
+        void _Commit();
+        /**
+         * Hands the complete bytes to the stream and moves to a new buffer
+         * of at least wanted bytes; a partly written byte moves along.
+         */
+        void _Next(size_t wanted);
+        /**
+         * Appends a field to the accumulator, storing it once it holds 64
+         * bits. value holds the numberOfBits bits of the field, left-aligned
+         * for MSBFirst and right-aligned (the rest zero) for LSBFirst.
+         */
+        void _PutBits(uint64_t value, int numberOfBits);
+        /**
+         * _PutBits() when the field does not fit in the accumulator, or a
+         * partly written byte has to be taken into it first.
+         */
+        void _StoreBits(uint64_t value, int numberOfBits);
+        /**
+         * Moves the accumulated bits to the buffer, so index_ and offset_
+         * are up to date for the byte writers.
+         */
+        void _DrainBits() {
+            if (bit_count_ > 0) {
+                _FlushBits();
+            }
+        }
+        void _FlushBits();
+        /**
+         * Writes count values of size bytes each.
+         */
+        void _WriteArray(const void* values, size_t size, size_t count);
     };
+    
+    /** The SWF layout: little-endian integers, bit fields most significant bit first. */
+    typedef BasicEncoder<LittleEndian, MSBFirst> Encoder;
+    /** Network byte order integers. */
+    typedef BasicEncoder<BigEndian, MSBFirst> BigEndianEncoder;
+    
+    // The bit writers are inline, so a field that fits in the accumulator
+    // costs a few shifts and no call.
+    template <class ByteOrder, class BitOrder, class Output>
+    inline void BasicEncoder<ByteOrder, BitOrder, Output>::_PutBits(uint64_t value, int numberOfBits) {
+        if (numberOfBits >= 64 - bit_count_ || offset_ > 0) {
+            _StoreBits(value, numberOfBits);
+            return;
+        }
+        if (BitOrder::MostSignificantFirst) {
+            bits_ |= value >> bit_count_;
+        } else {
+            bits_ |= value << bit_count_;
+        }
+        bit_count_ += numberOfBits;
+    }
+    
+    template <class ByteOrder, class BitOrder, class Output>
+    inline void BasicEncoder<ByteOrder, BitOrder, Output>::WriteBits64(uint64_t value, int numberOfBits) {
+        if (numberOfBits > 0 && numberOfBits <= 64) {
+            if (BitOrder::MostSignificantFirst) {
+                _PutBits(value << (64 - numberOfBits), numberOfBits);
+            } else {
+                _PutBits(value & (~(uint64_t)0 >> (64 - numberOfBits)), numberOfBits);
+            }
+        } else if (numberOfBits > 64) {
+            _SetError(BadArguments);
+        }
+    }
+    
+    template <class ByteOrder, class BitOrder, class Output>
+    void BasicEncoder<ByteOrder, BitOrder, Output>::_StoreBits(uint64_t value, int numberOfBits) {
+        if (numberOfBits <= 0) {
+            return;
+        }
+        if (buffer_ == NULL || (size_t)index_ + 8 > buffer_size_) {
+            _Next(8);
+        }
+        if (offset_ > 0) {
+            // A byte is only read back once partly written; the buffer may
+            // be a region of the stream holding anything.
+            if (BitOrder::MostSignificantFirst) {
+                bits_ = (uint64_t)(buffer_[index_] & (0xff00 >> offset_)) << 56;
+            } else {
+                bits_ = buffer_[index_] & ((1 << offset_) - 1);
+            }
+            bit_count_ = offset_;
+            offset_ = 0;
+        }
+        
+        int room = 64 - bit_count_;
+        if (BitOrder::MostSignificantFirst) {
+            bits_ |= value >> bit_count_;
+        } else {
+            bits_ |= value << bit_count_;
+        }
+        if (numberOfBits < room) {
+            bit_count_ += numberOfBits;
+            return;
+        }
+        BitOrder::WordOrder::Store64(buffer_ + index_, bits_);
+        index_ += 8;
+        if (room == 64) {
+            bits_ = 0;
+        } else if (BitOrder::MostSignificantFirst) {
+            bits_ = value << room;
+        } else {
+            bits_ = value >> room;
+        }
+        bit_count_ = numberOfBits - room;
+    }
+    
+    template <class ByteOrder, class BitOrder, class Output>
+    void BasicEncoder<ByteOrder, BitOrder, Output>::_FlushBits() {
+        if (buffer_ == NULL || (size_t)index_ + 8 > buffer_size_) {
+            _Next(8);
+        }
+        // The bytes past the last bit are not committed.
+        BitOrder::WordOrder::Store64(buffer_ + index_, bits_);
+        index_ += bit_count_ >> BITS_TO_BYTES;
+        offset_ = bit_count_ & LOWEST3;
+        bits_ = 0;
+        bit_count_ = 0;
+    }
+    
+    template <class ByteOrder, class BitOrder, class Output>
+    void BasicEncoder<ByteOrder, BitOrder, Output>::WritePackedBits(const uint32_t* values, size_t count, int numberOfBits) {
+        if (numberOfBits <= 0 || numberOfBits > BITS_PER_INT) {
+            _SetError(BadArguments);
+            return;
+        }
+        // Two fields at a time go into the accumulator as one.
+        uint64_t mask = ((uint64_t)1 << numberOfBits) - 1;
+        int shift = 64 - 2 * numberOfBits;
+        size_t i = 0;
+        for (; i + 1 < count; i += 2) {
+            if (BitOrder::MostSignificantFirst) {
+                uint64_t pair = ((uint64_t)values[i] << numberOfBits) | (values[i + 1] & mask);
+                _PutBits(pair << shift, 2 * numberOfBits);
+            } else {
+                uint64_t pair = (values[i] & mask) | ((values[i + 1] & mask) << numberOfBits);
+                _PutBits(pair, 2 * numberOfBits);
+            }
+        }
+        if (i < count) {
+            WriteBits64(values[i], numberOfBits);
+        }
+    }
+    
+    template <class ByteOrder, class BitOrder, class Output>
+    void BasicEncoder<ByteOrder, BitOrder, Output>::_WriteArray(const void* values, size_t size, size_t count) {
+        if (ByteOrder::IsHost) {
+            WriteBytes((const uint8_t*)values, size * count);
+            return;
+        }
+        // Swap a chunk at a time into the stream's byte order.
+        const uint8_t* p = (const uint8_t*)values;
+        uint8_t chunk[STR_BUFFER_SIZE];
+        size_t per_chunk = sizeof(chunk) / size;
+        while (count > 0) {
+            size_t n = count < per_chunk ? count : per_chunk;
+            memcpy(chunk, p, n * size);
+            SwapBytes(chunk, size, n);
+            WriteBytes(chunk, n * size);
+            p += n * size;
+            count -= n;
+        }
+    }
+    
+    template <class ByteOrder, class BitOrder, class Output>
+    void BasicEncoder<ByteOrder, BitOrder, Output>::_Commit() {
+        if (index_ > 0) {
+            if (buffer_ == own_buffer_) {
+                _Stream()->Write(own_buffer_, 1, index_);
+            } else {
+                _Stream()->Commit(index_);
+            }
+            position_ += index_;
+            index_ = 0;
+        }
+    }
+    
+    template <class ByteOrder, class BitOrder, class Output>
+    void BasicEncoder<ByteOrder, BitOrder, Output>::_Next(size_t wanted) {
+        uint8_t partial = offset_ > 0 ? buffer_[index_] : 0;
+        if (buffer_ != NULL) {
+            _Commit();
+        }
+        
+        size_t length = 0;
+        buffer_ = _Stream()->Reserve(wanted, &length);
+        if (buffer_ != NULL) {
+            buffer_size_ = length;
+        } else {
+            buffer_ = own_buffer_;
+            buffer_size_ = own_size_;
+        }
+        buffer_[0] = partial;
+    }
+    
+    template <class ByteOrder, class BitOrder, class Output>
+    void BasicEncoder<ByteOrder, BitOrder, Output>::Flush() {
+        _DrainBits();
+        if (buffer_ == NULL) {
+            _Stream()->Flush();
+            return;
+        }
+        AlignToByte();
+        _Commit();
+        // The stream may reuse the reserved region once flushed.
+        buffer_ = NULL;
+        buffer_size_ = 0;
+        _Stream()->Flush();
+    }
+    
+    template <class ByteOrder, class BitOrder, class Output>
+    size_t BasicEncoder<ByteOrder, BitOrder, Output>::WriteBytes(const uint8_t* bytes, size_t numOfBytes) {
+        _DrainBits();
+        size_t written = 0;
+        while (written < numOfBytes) {
+            size_t left = numOfBytes - written;
+            if (offset_ == 0 && left >= own_size_ && (buffer_ == NULL || index_ + left > buffer_size_)) {
+                // Too large to be worth a copy into the buffer.
+                if (buffer_ != NULL) {
+                    _Commit();
+                    buffer_ = NULL;
+                    buffer_size_ = 0;
+                }
+                _Stream()->Write(bytes + written, 1, left);
+                position_ += left;
+                break;
+            }
+            if (buffer_ == NULL || (size_t)index_ == buffer_size_) {
+                _Next(1);
+            }
+            size_t n = buffer_size_ - index_;
+            if (n > left) {
+                n = left;
+            }
+            memcpy(buffer_ + index_, bytes + written, n);
+            index_ += n;
+            written += n;
+        }
+        return numOfBytes;
+    }
+    
+    template <class ByteOrder, class BitOrder, class Output>
+    long BasicEncoder<ByteOrder, BitOrder, Output>::WritePlaceholder(size_t numOfBytes) {
+        _DrainBits();
+        long position = position_ + index_;
+        while (numOfBytes > 0) {
+            if (buffer_ == NULL || (size_t)index_ == buffer_size_) {
+                _Next(1);
+            }
+            size_t n = buffer_size_ - index_;
+            if (n > numOfBytes) {
+                n = numOfBytes;
+            }
+            memset(buffer_ + index_, 0, n);
+            index_ += n;
+            numOfBytes -= n;
+        }
+        return position;
+    }
+    
+    template <class ByteOrder, class BitOrder, class Output>
+    void BasicEncoder<ByteOrder, BitOrder, Output>::PatchBytes(long position, const uint8_t* bytes, size_t numOfBytes) {
+        _DrainBits();
+        long end = position + (long)numOfBytes;
+        if (position < 0 || end > position_ + index_) {
+            _SetError(BadArguments);
+            return;
+        }
+        // The part still in the buffer, if any, is not the stream's yet.
+        if (end > position_) {
+            long from = position > position_ ? position : position_;
+            memcpy(buffer_ + (from - position_), bytes + (from - position), end - from);
+            numOfBytes = from - position;
+        }
+        if (numOfBytes > 0 && !_Stream()->Patch(position, bytes, numOfBytes)) {
+            _SetError(FailedToSeek);
+        }
+    }
 }  /* binary_coder */
 
 #endif /* defined(BINARYCODER_ENCODER_H_) */
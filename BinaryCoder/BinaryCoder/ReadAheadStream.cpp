@@ -0,0 +1,249 @@
+//
+//  ReadAheadStream.cpp
+//  BinaryCoder
+//
+
+#include "ReadAheadStream.h"
+
+namespace binary_coder {
+
+    InputReadAhead::InputReadAhead(InputStream* source, size_t block_size)
+    {
+        source_ = source;
+        block_size_ = block_size < MIN_BUFFER_SIZE ? MIN_BUFFER_SIZE : block_size;
+        // A stream that cannot tell, such as a pipe, is taken to start here.
+        position_ = (long)source_->Tell();
+        if (position_ < 0) {
+            position_ = 0;
+        }
+        source_position_ = position_;
+        for (int i = 0; i < 2; i++) {
+            blocks_[i].data = new uint8_t[MIN_BUFFER_SIZE + block_size_] + MIN_BUFFER_SIZE;
+            blocks_[i].start = position_;
+            blocks_[i].length = 0;
+        }
+        current_ = 0;
+        eof_ = false;
+        err_ = NoError;
+        pending_ = false;
+        stop_ = false;
+
+        thread_ = std::thread(&InputReadAhead::_Work, this);
+        _Prefetch();
+    }
+
+    InputReadAhead::~InputReadAhead()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+        for (int i = 0; i < 2; i++) {
+            delete[] (blocks_[i].data - MIN_BUFFER_SIZE);
+        }
+    }
+
+    int InputReadAhead::Seek(long offset, int origin)
+    {
+        long begin = 0;
+        if (origin == SEEK_CUR) {
+            begin = position_;
+        } else if (origin == SEEK_END) {
+            _Wait();
+            if (source_->Seek(offset, SEEK_END) != 0) {
+                return -1;
+            }
+            source_position_ = (long)source_->Tell();
+            begin = source_position_;
+            offset = 0;
+        }
+        if (begin + offset < 0) {
+            return -1;
+        }
+        // The blocks are only read, or sought, once the bytes are asked for.
+        position_ = begin + offset;
+        eof_ = false;
+        return 0;
+    }
+
+    size_t InputReadAhead::Read(void* ptr, size_t size, size_t count)
+    {
+        size_t total = size * count;
+        size_t done = 0;
+        while (done < total) {
+            size_t length = 0;
+            const uint8_t* view = _View(&length);
+            if (length == 0) {
+                break;
+            }
+            if (length > total - done) {
+                length = total - done;
+            }
+            memcpy((uint8_t*)ptr + done, view, length);
+            done += length;
+            position_ += length;
+        }
+        return size > 0 ? done / size : 0;
+    }
+
+    size_t InputReadAhead::Tell() const
+    {
+        return position_;
+    }
+
+    int InputReadAhead::Eof() const
+    {
+        return eof_ ? 1 : 0;
+    }
+
+    error_t InputReadAhead::Error() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return err_;
+    }
+
+    const uint8_t* InputReadAhead::Lend(size_t* length)
+    {
+        return _View(length);
+    }
+
+    const uint8_t* InputReadAhead::_View(size_t* length)
+    {
+        while (true) {
+            Block* block = &blocks_[current_];
+            long end = block->start + (long)block->length;
+            bool inside = position_ >= block->start && position_ < end;
+            if (inside && (end - position_ >= MIN_BUFFER_SIZE || block->length < block_size_)) {
+                *length = end - position_;
+                return block->data + (position_ - block->start);
+            }
+
+            _Wait();
+            Block* next = &blocks_[1 - current_];
+            bool tail = inside && next->start == end;
+            if (tail) {
+                // The last few bytes go in front of the next block, so that
+                // the view holds any field that starts in them.
+                long count = end - position_;
+                memcpy(next->data - count, block->data + (position_ - block->start), count);
+            } else if (position_ < next->start || position_ >= next->start + (long)next->length) {
+                // A jump out of both blocks: the thread is idle, so the
+                // block at the new position is read here.
+                error_t err = NoError;
+                next->start = position_;
+                next->length = _Load(next->data, position_, &err);
+                if (err != NoError) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    _SetError(err);
+                }
+                tail = true;
+            }
+            current_ = 1 - current_;
+            if (next->length == block_size_) {
+                _Prefetch();
+            }
+            if (!tail) {
+                // Into the block read ahead, maybe near its end.
+                continue;
+            }
+
+            end = next->start + (long)next->length;
+            if (position_ >= end) {
+                eof_ = true;
+                *length = 0;
+                return next->data;
+            }
+            *length = end - position_;
+            return next->data + (position_ - next->start);
+        }
+    }
+
+    void InputReadAhead::_Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (pending_) {
+            done_.wait(lock);
+        }
+    }
+
+    void InputReadAhead::_Prefetch()
+    {
+        const Block& block = blocks_[current_];
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Block& next = blocks_[1 - current_];
+            next.start = block.start + (long)block.length;
+            next.length = 0;
+            pending_ = true;
+        }
+        wake_.notify_one();
+    }
+
+    size_t InputReadAhead::_Load(uint8_t* data, long start, error_t* err)
+    {
+        if (start != source_position_) {
+            if (source_->Seek(start, SEEK_SET) == 0) {
+                source_position_ = start;
+            } else if (start > source_position_) {
+                // Forward on a stream that cannot seek: read and drop the
+                // bytes in between.
+                while (start > source_position_) {
+                    size_t n = (size_t)(start - source_position_);
+                    if (n > block_size_) {
+                        n = block_size_;
+                    }
+                    size_t read = source_->Read(data, 1, n);
+                    if (read == 0) {
+                        return 0;
+                    }
+                    source_position_ += read;
+                }
+            } else {
+                *err = FailedToSeek;
+                return 0;
+            }
+        }
+
+        size_t length = 0;
+        while (length < block_size_) {
+            size_t read = source_->Read(data + length, 1, block_size_ - length);
+            if (read == 0) {
+                if (source_->Error() != NoError) {
+                    *err = source_->Error();
+                }
+                break;
+            }
+            length += read;
+        }
+        source_position_ += length;
+        return length;
+    }
+
+    void InputReadAhead::_Work()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            while (!stop_ && !pending_) {
+                wake_.wait(lock);
+            }
+            if (stop_) {
+                break;
+            }
+            Block& block = blocks_[1 - current_];
+            long start = block.start;
+            lock.unlock();
+            error_t err = NoError;
+            size_t length = _Load(block.data, start, &err);
+            lock.lock();
+            block.length = length;
+            if (err != NoError) {
+                _SetError(err);
+            }
+            pending_ = false;
+            done_.notify_all();
+        }
+    }
+
+} /* binary_coder */
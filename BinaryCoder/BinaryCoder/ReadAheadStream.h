@@ -0,0 +1,104 @@
+//
+//  ReadAheadStream.h
+//  BinaryCoder
+//
+
+#ifndef BINARYCODER_READAHEADSTREAM_H_
+#define BINARYCODER_READAHEADSTREAM_H_
+
+#include "Stream.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace binary_coder {
+
+    /**
+     * Input that reads the next block of another stream on a background
+     * thread while the current one is being decoded, so the decoding and
+     * the reads overlap instead of taking turns.
+     *
+     * It holds two blocks. The one at the position is lent (see Lend()),
+     * so a Decoder decodes it in place; the other one is filled with the
+     * bytes that follow. When the Decoder runs out and asks again, the
+     * blocks swap and the one just left is refilled in turn. A Seek() out
+     * of both blocks waits for the thread and reads the block at the new
+     * position on the calling thread.
+     *
+     * The source is only touched by one thread at a time, but must not be
+     * used by anything else while this stream is alive.
+     */
+    class InputReadAhead final: public InputStream
+    {
+    public:
+        /* source       the stream to read, not owned
+          block_size    the number of bytes read from source at a time
+         */
+        InputReadAhead(InputStream* source, size_t block_size = READ_AHEAD_SIZE);
+        ~InputReadAhead();
+
+        int Seek(long offset, int origin);
+        size_t Read(void* ptr, size_t size, size_t count);
+        size_t Tell() const;
+        int Eof() const;
+        error_t Error() const;
+        const uint8_t* Lend(size_t* length);
+
+    private:
+        struct Block {
+            /**
+             * The bytes, after MIN_BUFFER_SIZE bytes of room where the
+             * tail of the other block is copied, so that a view across
+             * the two is contiguous.
+             */
+            uint8_t* data;
+            long start;
+            size_t length;
+        };
+
+        /**
+         * The view from position_ on, at least MIN_BUFFER_SIZE bytes
+         * unless the data ends sooner; swaps or loads the blocks as needed.
+         */
+        const uint8_t* _View(size_t* length);
+        /** Waits until the thread has finished its block. */
+        void _Wait();
+        /** Has the thread fill the block that is not current_, after it. */
+        void _Prefetch();
+        /** Reads block_size_ bytes at start from source_ into data. */
+        size_t _Load(uint8_t* data, long start, error_t* err);
+        void _Work();
+
+        void _SetError(error_t err) {
+            if (err_ == NoError) {
+                err_ = err;
+            }
+        }
+
+        InputStream* source_;
+        size_t block_size_;
+        Block blocks_[2];
+        /** The block lent and read from; the thread only fills the other. */
+        int current_;
+        long position_;
+        /** Where source_ is, so it is only sought on a jump. */
+        long source_position_;
+        bool eof_;
+        error_t err_;
+
+        std::thread thread_;
+        mutable std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        /** Whether the thread is filling the other block. */
+        bool pending_;
+        bool stop_;
+
+        InputReadAhead(const InputReadAhead&);
+        InputReadAhead& operator=(const InputReadAhead&);
+    };
+
+} /* binary_coder */
+
+#endif /* defined(BINARYCODER_READAHEADSTREAM_H_) */
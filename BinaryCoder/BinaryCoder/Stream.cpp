@@ -1,5 +1,15 @@
 #include "Stream.h"
 
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <io.h>
+#endif
+#include <errno.h>
+
 namespace binary_coder {
     InputFile::InputFile(const char* filename, bool binary)
     {
@@ -152,6 +162,253 @@ namespace binary_coder {
         return err_;
     }
     
+    const uint8_t* InputMemoryBlock::Lend(size_t* length)
+    {
+        if (data_ == NULL || position_ > length_) {
+            *length = 0;
+            return NULL;
+        }
+        *length = length_ - position_;
+        return data_ + position_;
+    }
+    
+    //////////////////////////////////////////////////////////////////////////
+    
+    InputMappedFile::InputMappedFile(const char* filename, access_t access/* = AccessSequential*/)
+    {
+        data_ = NULL;
+        length_ = 0;
+        position_ = 0;
+        err_ = NoError;
+        
+#ifndef WIN32
+        int fd = open(filename, O_RDONLY);
+        if (fd < 0) {
+            _SetError(FailedToOpen);
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            _SetError(FailedToOpen);
+        } else if (st.st_size > 0) {
+            void* addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                _SetError(FailedToOpen);
+            } else {
+                data_ = (const uint8_t*)addr;
+                length_ = (size_t)st.st_size;
+            }
+        }
+        // The mapping keeps the file alive.
+        close(fd);
+        Advise(access);
+#else
+        // No mmap; keep the whole file in memory instead.
+        FILE* file = fopen(filename, "rb");
+        if (file == NULL) {
+            _SetError(FailedToOpen);
+            return;
+        }
+        if (fseek(file, 0, SEEK_END) == 0) {
+            long length = ftell(file);
+            if (length > 0) {
+                uint8_t* data = new uint8_t[length];
+                fseek(file, 0, SEEK_SET);
+                if (fread(data, 1, length, file) != (size_t)length) {
+                    delete[] data;
+                    _SetError(FailedToRead);
+                } else {
+                    data_ = data;
+                    length_ = length;
+                }
+            }
+        }
+        fclose(file);
+#endif
+    }
+    
+    InputMappedFile::~InputMappedFile()
+    {
+        if (data_ != NULL) {
+#ifndef WIN32
+            munmap((void*)data_, length_);
+#else
+            delete[] data_;
+#endif
+        }
+    }
+    
+    void InputMappedFile::Advise(access_t access)
+    {
+#ifndef WIN32
+        if (data_ == NULL) {
+            return;
+        }
+        int advice = MADV_NORMAL;
+        if (access == AccessSequential) {
+            advice = MADV_SEQUENTIAL;
+        } else if (access == AccessRandom) {
+            advice = MADV_RANDOM;
+        }
+        madvise((void*)data_, length_, advice);
+#endif
+    }
+    
+    int InputMappedFile::Seek(long offset, int origin)
+    {
+        if (err_ != NoError) {
+            return -1;
+        }
+        long begin = 0;
+        if (origin == SEEK_CUR) {
+            begin = (long)position_;
+        } else if (origin == SEEK_END) {
+            begin = (long)length_;
+        }
+        if (begin + offset < 0) {
+            return -1;
+        }
+        position_ = begin + offset;
+        return 0;
+    }
+    
+    size_t InputMappedFile::Read(void* ptr, size_t size, size_t count)
+    {
+        if (err_ != NoError || position_ >= length_) {
+            return 0;
+        }
+        size_t left = length_ - position_;
+        size_t toRead = size*count;
+        size_t read = toRead > left? left: toRead;
+        memcpy(ptr, data_+position_, read);
+        position_ += read;
+        return read;
+    }
+    
+    size_t InputMappedFile::Tell() const
+    {
+        if (err_ != NoError) {
+            return -1;
+        }
+        return position_;
+    }
+    
+    int InputMappedFile::Eof() const
+    {
+        if (position_ >= length_) {
+            return 1;
+        } else {
+            return 0;
+        }
+    }
+    
+    error_t InputMappedFile::Error() const
+    {
+        return err_;
+    }
+    
+    const uint8_t* InputMappedFile::Lend(size_t* length)
+    {
+        if (err_ != NoError || data_ == NULL || position_ > length_) {
+            *length = 0;
+            return NULL;
+        }
+        *length = length_ - position_;
+        return data_ + position_;
+    }
+    
+    //////////////////////////////////////////////////////////////////////////
+    
+    InputFileDescriptor::InputFileDescriptor(int fd, bool own_fd/* = false*/)
+    {
+        fd_ = fd;
+        own_fd_ = own_fd;
+        eof_ = false;
+        position_ = 0;
+        err_ = NoError;
+        if (fd_ < 0) {
+            _SetError(InvalidFile);
+        }
+    }
+    
+    InputFileDescriptor::~InputFileDescriptor()
+    {
+        if (own_fd_ && fd_ >= 0) {
+            close(fd_);
+        }
+    }
+    
+    int InputFileDescriptor::Seek(long offset, int origin)
+    {
+        if (err_ != NoError || origin == SEEK_END) {
+            return -1;
+        }
+        if (origin == SEEK_SET) {
+            offset -= (long)position_;
+        }
+        if (offset < 0) {
+            return -1;
+        }
+        uint8_t scratch[BUFFER_SIZE];
+        while (offset > 0) {
+            size_t n = offset > (long)sizeof(scratch)? sizeof(scratch): (size_t)offset;
+            size_t read = Read(scratch, 1, n);
+            if (read < n) {
+                return -1;
+            }
+            offset -= (long)n;
+        }
+        return 0;
+    }
+    
+    size_t InputFileDescriptor::Read(void* ptr, size_t size, size_t count)
+    {
+        if (err_ != NoError || eof_) {
+            return 0;
+        }
+        // Pipes return whatever is there; keep reading until the request
+        // is met or the writer is gone, like fread().
+        uint8_t* p = (uint8_t*)ptr;
+        size_t wanted = size*count;
+        size_t got = 0;
+        while (got < wanted) {
+#ifndef WIN32
+            ssize_t n = read(fd_, p + got, wanted - got);
+#else
+            int n = _read(fd_, p + got, (unsigned)(wanted - got));
+#endif
+            if (n > 0) {
+                got += n;
+            } else if (n == 0) {
+                eof_ = true;
+                break;
+            } else if (errno != EINTR) {
+                _SetError(FailedToRead);
+                break;
+            }
+        }
+        position_ += got;
+        return got;
+    }
+    
+    size_t InputFileDescriptor::Tell() const
+    {
+        if (err_ != NoError) {
+            return -1;
+        }
+        return position_;
+    }
+    
+    int InputFileDescriptor::Eof() const
+    {
+        return eof_? 1: 0;
+    }
+    
+    error_t InputFileDescriptor::Error() const
+    {
+        return err_;
+    }
+    
     //////////////////////////////////////////////////////////////////////////
     
     OutputFile::OutputFile(const char* filename, bool binary)
@@ -167,6 +424,7 @@ namespace binary_coder {
         own_file_ = true;
         is_sealed_ = false;
         err_ = NoError;
+        origin_ = file_ != NULL ? ftell(file_) : -1;
     }
     
     OutputFile::OutputFile(FILE* file, bool own_file/* = false*/)
@@ -178,6 +436,7 @@ namespace binary_coder {
         own_file_ = own_file;
         is_sealed_ = false;
         err_ = NoError;
+        origin_ = file_ != NULL ? ftell(file_) : -1;
     }
     
     OutputFile::~OutputFile()
@@ -220,4 +479,28 @@ namespace binary_coder {
     {
         is_sealed_ = true;
     }
+    
+    bool OutputFile::Patch(size_t offset, const void* ptr, size_t count)
+    {
+        if (err_ != NoError || origin_ < 0) {
+            return false;
+        }
+        if (is_sealed_) {
+            _SetError(StreamIsClosed);
+            return false;
+        }
+        long end = ftell(file_);
+        long at = origin_ + (long)offset;
+        if (end < 0 || at + (long)count > end || fseek(file_, at, SEEK_SET) != 0) {
+            return false;
+        }
+        size_t written = fwrite(ptr, 1, count, file_);
+        if (written < count && ferror(file_) != 0) {
+            _SetError(FailedToWrite);
+        }
+        if (fseek(file_, end, SEEK_SET) != 0) {
+            _SetError(FailedToWrite);
+        }
+        return written == count && err_ == NoError;
+    }
 } /* binary_coder */
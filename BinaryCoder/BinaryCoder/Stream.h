@@ -64,6 +64,21 @@ namespace binary_coder {
          * @return the error code.
          */
         virtual error_t Error() const = 0;
+        
+        /**
+         * Lends a view of the bytes from the current position on, without
+         * copying them. The position is not changed; Seek() past the bytes
+         * used. The view stays valid until the next call to Seek(), Read()
+         * or Lend(), or the destruction of the stream.
+         * @param length
+         *          Receives the number of bytes in the view.
+         * @return the view, or NULL if the stream cannot lend its data, in
+         *      which case Read() must be used.
+         */
+        virtual const uint8_t* Lend(size_t* length) {
+            *length = 0;
+            return NULL;
+        }
     };
     
     /**
@@ -97,9 +112,48 @@ namespace binary_coder {
          * @return the error code.
          */
         virtual error_t Error() const = 0;
+        
+        /**
+         * Reserves a writable region at the end of the stream, so that a
+         * producer can fill it in place instead of passing a copy to
+         * Write(). Nothing is written until Commit() is called. The region
+         * stays valid until the next call to any other method of the stream.
+         * @param min
+         *          Minimal number of bytes wanted.
+         * @param length
+         *          Receives the size of the region, at least min.
+         * @return the region, or NULL if the stream cannot lend its buffer
+         *      (or not min bytes of it), in which case Write() must be used.
+         */
+        virtual uint8_t* Reserve(size_t min, size_t* length) {
+            *length = 0;
+            return NULL;
+        }
+        
+        /**
+         * Appends the first count bytes of the region returned by the last
+         * Reserve() call to the stream.
+         */
+        virtual void Commit(size_t count) {}
+        
+        /**
+         * Overwrites bytes already written, such as a length field that is
+         * only known once what follows it is written. The end of the
+         * stream does not move.
+         * @param offset
+         *          Position of the first byte to overwrite, counted from the
+         *      first byte written to the stream.
+         * @param ptr
+         *          The count new bytes.
+         * @return false if the stream cannot go back, or the bytes were
+         *      not all written yet.
+         */
+        virtual bool Patch(size_t offset, const void* ptr, size_t count) {
+            return false;
+        }
     };
     
-    class InputFile: public InputStream
+    class InputFile final: public InputStream
     {
     public:
         InputFile(const char* filename, bool binary);
@@ -123,7 +177,7 @@ namespace binary_coder {
         }
     };
     
-    class InputMemoryBlock: public InputStream
+    class InputMemoryBlock final: public InputStream
     {
     public:
         InputMemoryBlock(const uint8_t* data, size_t dataLength, bool copy);
@@ -134,6 +188,7 @@ namespace binary_coder {
         size_t Tell() const;
         int Eof() const;
         error_t Error() const;
+        const uint8_t* Lend(size_t* length);
     private:
         union {
             const uint8_t* data_;
@@ -152,8 +207,103 @@ namespace binary_coder {
         }
     };
     
+    /**
+     * Input from a file mapped read-only into memory. Seek(), Tell() and
+     * Read() are pointer arithmetic and a memcpy from the mapping, with no
+     * stdio buffer in between, so skipping around a large file only
+     * touches the pages that are actually read.
+     */
+    class InputMappedFile final: public InputStream
+    {
+    public:
+        /** Access pattern hints, passed to madvise(). */
+        enum access_t {
+            AccessNormal,
+            /** Read ahead aggressively and drop pages once read. */
+            AccessSequential,
+            /** No read-ahead, for heavy seeking. */
+            AccessRandom,
+        };
+        
+        InputMappedFile(const char* filename, access_t access = AccessSequential);
+        ~InputMappedFile();
+        
+        int Seek(long offset, int origin);
+        size_t Read(void* ptr, size_t size, size_t count);
+        size_t Tell() const;
+        int Eof() const;
+        error_t Error() const;
+        const uint8_t* Lend(size_t* length);
+        
+        /**
+         * Changes the access pattern hint for the whole file.
+         */
+        void Advise(access_t access);
+        
+        /** The mapped file contents, NULL for an empty or unopened file. */
+        const uint8_t* Data() const {
+            return data_;
+        }
+        
+        size_t Length() const {
+            return length_;
+        }
+    private:
+        const uint8_t* data_;
+        size_t length_;
+        size_t position_;
+        error_t err_;
+        
+        void _SetError(error_t err) {
+            if (err_ == NoError) {
+                err_ = err;
+            }
+        }
+        
+        InputMappedFile(const InputMappedFile&);
+        InputMappedFile& operator=(const InputMappedFile&);
+    };
+    
+    /**
+     * Input from a file descriptor, such as a pipe, a socket or stdin, that
+     * is only ever read front to back. Tell() counts the bytes consumed
+     * since construction. Seek() only goes forward, by reading and
+     * discarding the bytes in between; seeking back, or from the end,
+     * fails.
+     */
+    class InputFileDescriptor final: public InputStream
+    {
+    public:
+        /* fd         the descriptor to read, e.g. 0 for stdin
+          own_fd      close fd together with this stream
+         */
+        InputFileDescriptor(int fd, bool own_fd = false);
+        ~InputFileDescriptor();
+        
+        int Seek(long offset, int origin);
+        size_t Read(void* ptr, size_t size, size_t count);
+        size_t Tell() const;
+        int Eof() const;
+        error_t Error() const;
+    private:
+        int fd_;
+        bool own_fd_;
+        bool eof_;
+        size_t position_;
+        error_t err_;
+        
+        void _SetError(error_t err) {
+            if (err_ == NoError) {
+                err_ = err;
+            }
+        }
+        
+        InputFileDescriptor(const InputFileDescriptor&);
+        InputFileDescriptor& operator=(const InputFileDescriptor&);
+    };
+    
     //////////
-    class OutputFile: public OutputStream
+    class OutputFile final: public OutputStream
     {
     public:
         OutputFile(const char* filename, bool binary);
@@ -164,11 +314,16 @@ namespace binary_coder {
         virtual void Flush();
         virtual void Seal();
         virtual error_t Error() const { return err_; }
+        /* Seeks back, writes and seeks to the end again; fails on pipes
+          and, being offset arithmetic, on text files. */
+        virtual bool Patch(size_t offset, const void* ptr, size_t count);
     private:
         FILE* file_;
         error_t err_;
         bool own_file_;
         bool is_sealed_;
+        /** Where the file was when the stream was created, -1 if it cannot seek. */
+        long origin_;
         
         void _SetError(error_t err) {
             if (err_ == NoError) {
@@ -0,0 +1,121 @@
+//
+//  WorkerPool.cpp
+//  BinaryCoder
+//
+
+#include "WorkerPool.h"
+
+namespace binary_coder {
+
+    WorkerPool::WorkerPool(size_t workers)
+    {
+        task_ = NULL;
+        count_ = 0;
+        next_ = 0;
+        pending_ = 0;
+        stop_ = false;
+
+        for (size_t i = 1; i < workers; i++) {
+            threads_.push_back(std::thread(&WorkerPool::_Work, this));
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (size_t i = 0; i < threads_.size(); i++) {
+            threads_[i].join();
+        }
+    }
+
+    void WorkerPool::Run(size_t count, const std::function<void(size_t)>& task)
+    {
+        if (threads_.empty() || count < 2) {
+            for (size_t i = 0; i < count; i++) {
+                task(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        std::unique_lock<std::mutex> lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        next_ = 0;
+        pending_ = count;
+        wake_.notify_all();
+
+        while (next_ < count_) {
+            size_t i = next_++;
+            lock.unlock();
+            task(i);
+            lock.lock();
+            pending_--;
+        }
+        while (pending_ > 0) {
+            done_.wait(lock);
+        }
+        task_ = NULL;
+    }
+
+    void WorkerPool::_Work()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            while (!stop_ && (task_ == NULL || next_ >= count_)) {
+                wake_.wait(lock);
+            }
+            if (stop_) {
+                break;
+            }
+            const std::function<void(size_t)>* task = task_;
+            size_t i = next_++;
+            lock.unlock();
+            (*task)(i);
+            lock.lock();
+            if (--pending_ == 0) {
+                done_.notify_all();
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+
+    size_t RangeLength(WorkerPool* pool, size_t count, size_t granule, size_t min_count)
+    {
+        if (pool == NULL || pool->Workers() < 2 || count < min_count || count == 0) {
+            return count;
+        }
+        if (granule == 0) {
+            granule = 1;
+        }
+        size_t workers = pool->Workers();
+        size_t per_range = (count + workers - 1) / workers;
+        return (per_range + granule - 1) / granule * granule;
+    }
+
+    void ParallelRanges(WorkerPool* pool, size_t count, size_t granule, size_t min_count,
+                        const std::function<void(size_t, size_t)>& fn)
+    {
+        if (count == 0) {
+            return;
+        }
+        size_t per_range = RangeLength(pool, count, granule, min_count);
+        if (per_range >= count) {
+            fn(0, count);
+            return;
+        }
+
+        size_t ranges = (count + per_range - 1) / per_range;
+        pool->Run(ranges, [&](size_t i) {
+            size_t begin = i * per_range;
+            size_t end = begin + per_range > count ? count : begin + per_range;
+            fn(begin, end);
+        });
+    }
+
+} /* binary_coder */
@@ -0,0 +1,87 @@
+//
+//  WorkerPool.h
+//  BinaryCoder
+//
+
+#ifndef BINARYCODER_WORKERPOOL_H_
+#define BINARYCODER_WORKERPOOL_H_
+
+#include "STDHeaders.h"
+#include "Constants.h"
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace binary_coder {
+
+    /**
+     * A fixed set of threads for splitting independent work, such as the
+     * blocks of an ECB buffer. The thread that calls Run() takes part in
+     * the work, so a pool of N workers starts N-1 threads.
+     *
+     * A pool can be shared by any number of streams; concurrent calls to
+     * Run() are served one after another.
+     */
+    class WorkerPool
+    {
+    public:
+        /**
+         * @param workers
+         *          Number of threads working on a job, including the caller
+         *      of Run(). Values below 1 are treated as 1.
+         */
+        WorkerPool(size_t workers);
+        ~WorkerPool();
+
+        size_t Workers() const {
+            return threads_.size() + 1;
+        }
+
+        /**
+         * Calls task(i) for every i in [0, count) and returns once all of
+         * them have finished. Tasks run in no particular order.
+         */
+        void Run(size_t count, const std::function<void(size_t)>& task);
+
+    private:
+        void _Work();
+
+        std::vector<std::thread> threads_;
+        std::mutex run_mutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+
+        const std::function<void(size_t)>* task_;
+        size_t count_;
+        size_t next_;
+        size_t pending_;
+        bool stop_;
+
+        WorkerPool(const WorkerPool&);
+        WorkerPool& operator=(const WorkerPool&);
+    };
+
+    /**
+     * Splits the items [0, count) into one contiguous range per worker and
+     * calls fn(begin, end) for each range on the pool. Every range but the
+     * last is a multiple of granule items, so block kernels that work best
+     * on full batches stay fed.
+     * The work runs on the calling thread when pool is NULL, has a single
+     * worker, or count is less than min_count.
+     */
+    void ParallelRanges(WorkerPool* pool, size_t count, size_t granule, size_t min_count,
+                        const std::function<void(size_t, size_t)>& fn);
+
+    /**
+     * Length of the ranges ParallelRanges() makes for the same arguments
+     * (count itself when it runs the work in one piece). Range i starts at
+     * i times this length.
+     */
+    size_t RangeLength(WorkerPool* pool, size_t count, size_t granule, size_t min_count);
+
+} /* binary_coder */
+
+#endif /* defined(BINARYCODER_WORKERPOOL_H_) */
@@ -1,5 +1,8 @@
-typedef unsigned long DES_KS[16][2];	/* Single-key DES key schedule */
-typedef unsigned long DES3_KS[48][2];	/* Triple-DES key schedule */
+#include <stdint.h>
+
+/* Each subkey word holds four 6-bit chunks, one per byte (see deskey.c) */
+typedef uint32_t DES_KS[16][2];	/* Single-key DES key schedule */
+typedef uint32_t DES3_KS[48][2];	/* Triple-DES key schedule */
 
 /* In deskey.c: */
 void deskey(DES_KS,unsigned char *,int);
@@ -7,8 +10,16 @@ void des3key(DES3_KS,unsigned char *,int);
 
 /* In desport.c, desborl.cas or desgnu.s: */
 void des(DES_KS,unsigned char *);
+/* In desport.c: four blocks, each with its own DES_KS (1 stage) or DES3_KS (3 stages) */
+void des4(uint32_t (*const [4])[2],int,unsigned char *const [4]);
 /* In des3port.c, des3borl.cas or des3gnu.s: */
 void des3(DES3_KS,unsigned char *);
+/* In desbs.cpp (bitsliced engine, same key schedules as des()/des3()): */
+int desbs_width(void);	/* Number of blocks handled by one desbs() call */
+void desbs(DES_KS,unsigned char *);	/* Process desbs_width() blocks */
+void desecb(DES_KS,unsigned char *,unsigned long);	/* Process any number of blocks */
+void des3bs(DES3_KS,unsigned char *);	/* Process desbs_width() blocks */
+void des3ecb(DES3_KS,unsigned char *,unsigned long);	/* Process any number of blocks */
 
 extern int Asmversion;	/* 1 if we're linked with an asm version, 0 if C */
 
@@ -0,0 +1,118 @@
+/* Portable C version of des3() function */
+
+#include "des.h"
+
+/* Combined SP lookup table, linked in (see spbox.cpp) */
+extern const uint32_t Spbox[8][64];		/* Combined S and P boxes */
+
+/* Primitive function F, same as in desport.c */
+#define	F(l,r,key){\
+	work = ((r >> 4) | (r << 28)) ^ key[0];\
+	l ^= Spbox[6][work & 0x3f];\
+	l ^= Spbox[4][(work >> 8) & 0x3f];\
+	l ^= Spbox[2][(work >> 16) & 0x3f];\
+	l ^= Spbox[0][(work >> 24) & 0x3f];\
+	work = r ^ key[1];\
+	l ^= Spbox[7][work & 0x3f];\
+	l ^= Spbox[5][(work >> 8) & 0x3f];\
+	l ^= Spbox[3][(work >> 16) & 0x3f];\
+	l ^= Spbox[1][(work >> 24) & 0x3f];\
+}
+
+/* Sixteen rounds starting with F(l,r,...) */
+#define	ROUNDS(l,r,ks){\
+	F(l,r,ks[0]);\
+	F(r,l,ks[1]);\
+	F(l,r,ks[2]);\
+	F(r,l,ks[3]);\
+	F(l,r,ks[4]);\
+	F(r,l,ks[5]);\
+	F(l,r,ks[6]);\
+	F(r,l,ks[7]);\
+	F(l,r,ks[8]);\
+	F(r,l,ks[9]);\
+	F(l,r,ks[10]);\
+	F(r,l,ks[11]);\
+	F(l,r,ks[12]);\
+	F(r,l,ks[13]);\
+	F(l,r,ks[14]);\
+	F(r,l,ks[15]);\
+}
+
+/* Encrypt or decrypt a block of data in ECB mode with triple DES.
+ *
+ * The three DES operations are fused: the final permutation of one stage
+ * and the initial permutation of the next cancel out, leaving only the
+ * swap of the two halves, which is done by exchanging the roles of left
+ * and right in the middle stage. So IP and FP are done once per block.
+ */
+void
+des3(DES3_KS ks,	/* Key schedule */
+     unsigned char *block	/* Data block */
+     )
+{
+	uint32_t left,right,work;
+
+	/* Read input block and place in left/right in big-endian order */
+	left = ((uint32_t)block[0] << 24)
+	 | ((uint32_t)block[1] << 16)
+	 | ((uint32_t)block[2] << 8)
+	 | (uint32_t)block[3];
+	right = ((uint32_t)block[4] << 24)
+	 | ((uint32_t)block[5] << 16)
+	 | ((uint32_t)block[6] << 8)
+	 | (uint32_t)block[7];
+
+	/* Initial permutation, see desport.c */
+	work = ((left >> 4) ^ right) & 0x0f0f0f0f;
+	right ^= work;
+	left ^= work << 4;
+	work = ((left >> 16) ^ right) & 0xffff;
+	right ^= work;
+	left ^= work << 16;
+	work = ((right >> 2) ^ left) & 0x33333333;
+	left ^= work;
+	right ^= (work << 2);
+	work = ((right >> 8) ^ left) & 0xff00ff;
+	left ^= work;
+	right ^= (work << 8);
+	right = (right << 1) | (right >> 31);
+	work = (left ^ right) & 0xaaaaaaaa;
+	left ^= work;
+	right ^= work;
+	left = (left << 1) | (left >> 31);
+
+	/* Now do the 48 rounds; the middle stage starts from the swapped halves */
+	ROUNDS(left,right,(&ks[0]));
+	ROUNDS(right,left,(&ks[16]));
+	ROUNDS(left,right,(&ks[32]));
+
+	/* Inverse permutation, see desport.c */
+	right = (right << 31) | (right >> 1);
+	work = (left ^ right) & 0xaaaaaaaa;
+	left ^= work;
+	right ^= work;
+	left = (left >> 1) | (left  << 31);
+	work = ((left >> 8) ^ right) & 0xff00ff;
+	right ^= work;
+	left ^= work << 8;
+	work = ((left >> 2) ^ right) & 0x33333333;
+	right ^= work;
+	left ^= work << 2;
+	work = ((right >> 16) ^ left) & 0xffff;
+	left ^= work;
+	right ^= work << 16;
+	work = ((right >> 4) ^ left) & 0x0f0f0f0f;
+	left ^= work;
+	right ^= work << 4;
+
+	/* Put the block back into the user's buffer with final swap */
+	block[0] = right >> 24;
+	block[1] = right >> 16;
+	block[2] = right >> 8;
+	block[3] = right;
+	block[4] = left >> 24;
+	block[5] = left >> 16;
+	block[6] = left >> 8;
+	block[7] = left;
+}
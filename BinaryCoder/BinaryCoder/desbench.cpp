@@ -0,0 +1,231 @@
+/* This program measures the cost of the portable one-block DES, des(),
+ * with the S/P box table and key schedule stored in 32-bit words (the
+ * layout used by desport.c) and in 64-bit words (the unsigned long layout
+ * they had on LP64 targets), in cycles per byte.
+ *
+ * Usage: desbench [streams]
+ *
+ * `streams' independent key schedules (default 64) are used round-robin,
+ * one block each, like many DES streams sharing a core. With 64-bit words
+ * the S/P box takes 4 KB and every schedule 256 bytes, twice as much L1
+ * as with 32-bit words.
+ *
+ * Build it together with spbox.cpp, deskey.c and desport.c, e.g.
+ *   cc -O2 -c deskey.c desport.c
+ *   c++ -O2 -std=c++11 desbench.cpp spbox.cpp deskey.o desport.o
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <chrono>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define HAVE_RDTSC
+#endif
+
+extern "C" {
+#include "des.h"
+extern const uint32_t Spbox[8][64];
+}
+
+namespace {
+
+/* des() from desport.c over any word type W; only the low 32 bits of W
+ * are significant.
+ */
+#define	F(l,r,key){\
+	work = ((r >> 4) | (r << 28)) ^ key[0];\
+	l ^= sp[6][work & 0x3f];\
+	l ^= sp[4][(work >> 8) & 0x3f];\
+	l ^= sp[2][(work >> 16) & 0x3f];\
+	l ^= sp[0][(work >> 24) & 0x3f];\
+	work = r ^ key[1];\
+	l ^= sp[7][work & 0x3f];\
+	l ^= sp[5][(work >> 8) & 0x3f];\
+	l ^= sp[3][(work >> 16) & 0x3f];\
+	l ^= sp[1][(work >> 24) & 0x3f];\
+}
+
+template <class W>
+void
+des_words(const W sp[8][64], const W ks[16][2], unsigned char *block)
+{
+	W left, right, work;
+
+	left = ((W)block[0] << 24) | ((W)block[1] << 16) | ((W)block[2] << 8) | (W)block[3];
+	right = ((W)block[4] << 24) | ((W)block[5] << 16) | ((W)block[6] << 8) | (W)block[7];
+
+	work = ((left >> 4) ^ right) & 0x0f0f0f0f;
+	right ^= work;
+	left ^= work << 4;
+	work = ((left >> 16) ^ right) & 0xffff;
+	right ^= work;
+	left ^= work << 16;
+	work = ((right >> 2) ^ left) & 0x33333333;
+	left ^= work;
+	right ^= (work << 2);
+	work = ((right >> 8) ^ left) & 0xff00ff;
+	left ^= work;
+	right ^= (work << 8);
+	right = ((right << 1) | (right >> 31)) & 0xffffffff;
+	work = (left ^ right) & 0xaaaaaaaa;
+	left ^= work;
+	right ^= work;
+	left = ((left << 1) | (left >> 31)) & 0xffffffff;
+
+	for (int i = 0; i < 16; i += 2) {
+		F(left, right, ks[i]);
+		F(right, left, ks[i+1]);
+	}
+
+	right = ((right << 31) | (right >> 1)) & 0xffffffff;
+	work = (left ^ right) & 0xaaaaaaaa;
+	left ^= work;
+	right ^= work;
+	left = ((left >> 1) | (left << 31)) & 0xffffffff;
+	work = ((left >> 8) ^ right) & 0xff00ff;
+	right ^= work;
+	left ^= work << 8;
+	work = ((left >> 2) ^ right) & 0x33333333;
+	right ^= work;
+	left ^= work << 2;
+	work = ((right >> 16) ^ left) & 0xffff;
+	left ^= work;
+	right ^= work << 16;
+	work = ((right >> 4) ^ left) & 0x0f0f0f0f;
+	left ^= work;
+	right ^= work << 4;
+
+	block[0] = right >> 24;
+	block[1] = right >> 16;
+	block[2] = right >> 8;
+	block[3] = right;
+	block[4] = left >> 24;
+	block[5] = left >> 16;
+	block[6] = left >> 8;
+	block[7] = left;
+}
+
+uint64_t
+ticks()
+{
+#ifdef HAVE_RDTSC
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+template <class W>
+double
+measure(const W sp[8][64], const std::vector<W>& schedules, int streams,
+	std::vector<unsigned char>& data)
+{
+	const W (*ks)[16][2] = (const W (*)[16][2])&schedules[0];
+	size_t blocks = data.size() >> 3;
+	double best = 0;
+
+	for (int run = 0; run < 5; run++) {
+		uint64_t start = ticks();
+		for (size_t b = 0; b < blocks; b++) {
+			des_words<W>(sp, ks[b % streams], &data[b << 3]);
+		}
+		double t = (double)(ticks() - start) / data.size();
+		if (run == 0 || t < best) {
+			best = t;
+		}
+	}
+	return best;
+}
+
+template <class W>
+double
+bench(int streams, std::vector<unsigned char>& data, const std::vector<unsigned char>& expected)
+{
+	static W sp[8][64];
+	std::vector<W> schedules((size_t)streams * 32);
+
+	for (int s = 0; s < 8; s++) {
+		for (int i = 0; i < 64; i++) {
+			sp[s][i] = Spbox[s][i];
+		}
+	}
+	for (int n = 0; n < streams; n++) {
+		unsigned char key[8];
+		DES_KS ks;
+		for (int i = 0; i < 8; i++) {
+			key[i] = (unsigned char)(n * 8 + i);
+		}
+		deskey(ks, key, 0);
+		for (int i = 0; i < 32; i++) {
+			schedules[(size_t)n * 32 + i] = ks[i >> 1][i & 1];
+		}
+	}
+
+	std::vector<unsigned char> copy = data;
+	measure<W>(sp, schedules, streams, copy);	/* warm up */
+	copy = data;
+	double t = measure<W>(sp, schedules, streams, copy);
+
+	/* One pass over the copy must give the reference ciphertext */
+	copy = data;
+	const W (*ks)[16][2] = (const W (*)[16][2])&schedules[0];
+	for (size_t b = 0; b < (copy.size() >> 3); b++) {
+		des_words<W>(sp, ks[b % streams], &copy[b << 3]);
+	}
+	if (copy != expected) {
+		fprintf(stderr, "%d-bit layout gives wrong ciphertext\n", (int)sizeof(W) * 8);
+		exit(1);
+	}
+	return t;
+}
+
+} /* namespace */
+
+int
+main(int argc, char *argv[])
+{
+	int streams = argc > 1 ? atoi(argv[1]) : 64;
+	if (streams < 1) {
+		streams = 1;
+	}
+
+	std::vector<unsigned char> data(1 << 20);
+	for (size_t i = 0; i < data.size(); i++) {
+		data[i] = (unsigned char)(i * 131 + 7);
+	}
+
+	/* Reference ciphertext from des() itself */
+	std::vector<unsigned char> expected = data;
+	DES_KS *schedules = new DES_KS[streams];
+	for (int n = 0; n < streams; n++) {
+		unsigned char key[8];
+		for (int i = 0; i < 8; i++) {
+			key[i] = (unsigned char)(n * 8 + i);
+		}
+		deskey(schedules[n], key, 0);
+	}
+	for (size_t b = 0; b < (expected.size() >> 3); b++) {
+		des(schedules[b % streams], &expected[b << 3]);
+	}
+	delete[] schedules;
+
+#ifdef HAVE_RDTSC
+	const char *unit = "cycles/byte";
+#else
+	const char *unit = "ns/byte";
+#endif
+	double t32 = bench<uint32_t>(streams, data, expected);
+	double t64 = bench<uint64_t>(streams, data, expected);
+	printf("%d key schedules, %u KB of data\n", streams, (unsigned)(data.size() >> 10));
+	printf("  32-bit tables (%5u bytes): %6.2f %s\n",
+	       (unsigned)(sizeof(uint32_t) * (512 + 32 * streams)), t32, unit);
+	printf("  64-bit tables (%5u bytes): %6.2f %s\n",
+	       (unsigned)(sizeof(uint64_t) * (512 + 32 * streams)), t64, unit);
+	return 0;
+}
@@ -0,0 +1,136 @@
+/* Bitsliced multi-block DES engine.
+ *
+ * des() processes one block at a time. Here 64 blocks are transposed into
+ * 64 "slices" so that slice i holds bit i of every block; the 16 rounds are
+ * then evaluated with plain boolean operations on whole slices, which lets
+ * one instruction work on 64, 128, 256 or 512 blocks at once depending on
+ * the register width. The initial/final permutations, the expansion E and
+ * the permutation P become free renaming of slices, and the S-boxes are
+ * evaluated as gate circuits (see desbs_sbox.h, generated by genbs.c).
+ *
+ * The slice width is picked at run time from the features of the CPU (see
+ * CPUFeatures.h): AVX-512, AVX2 and SSE2 slices are compiled in their own
+ * files for their own instruction sets, so one binary uses the widest
+ * registers the machine has. NEON is part of the ARMv8 baseline
+ * and is chosen at compile time.
+ *
+ * The engine uses the same key schedules as des() and des3(), so
+ * decryption is just a matter of passing a schedule made with
+ * deskey(..., 1) or des3key(..., 1).
+ */
+
+#include "desbs_impl.h"
+#include "CPUFeatures.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+struct SliceNEON {
+	enum { Lanes = 2 };
+	uint64x2_t v;
+	static SliceNEON load(const uint64_t *p) { SliceNEON r; r.v = vld1q_u64(p); return r; }
+	static SliceNEON splat(uint64_t x) { SliceNEON r; r.v = vdupq_n_u64(x); return r; }
+	void store(uint64_t *p) const { vst1q_u64(p, v); }
+};
+static inline SliceNEON operator&(const SliceNEON& a, const SliceNEON& b) { SliceNEON r; r.v = vandq_u64(a.v, b.v); return r; }
+static inline SliceNEON operator|(const SliceNEON& a, const SliceNEON& b) { SliceNEON r; r.v = vorrq_u64(a.v, b.v); return r; }
+static inline SliceNEON operator^(const SliceNEON& a, const SliceNEON& b) { SliceNEON r; r.v = veorq_u64(a.v, b.v); return r; }
+static inline SliceNEON andn(const SliceNEON& a, const SliceNEON& b) { SliceNEON r; r.v = vbicq_u64(b.v, a.v); return r; }
+#endif
+
+
+static const desbs_kernel portable_kernel = { 64, crypt_slices<SliceU64> };
+
+static const desbs_kernel *
+select_kernel(void)
+{
+	const binary_coder::CPUFeatures& cpu = binary_coder::GetCPUFeatures();
+	const desbs_kernel *kernel = NULL;
+
+	if (cpu.avx512) {
+		kernel = desbs_kernel_avx512();
+	}
+	if (kernel == NULL && cpu.avx2) {
+		kernel = desbs_kernel_avx2();
+	}
+	if (kernel == NULL && cpu.sse2) {
+		kernel = desbs_kernel_sse2();
+	}
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	if (kernel == NULL) {
+		static const desbs_kernel neon_kernel = { 64*SliceNEON::Lanes, crypt_slices<SliceNEON> };
+		kernel = &neon_kernel;
+	}
+#endif
+	return kernel != NULL ? kernel : &portable_kernel;
+}
+
+/* The widest kernel for this CPU, picked on the first call */
+static const desbs_kernel *
+wide_kernel(void)
+{
+	static const desbs_kernel *const kernel = select_kernel();
+	return kernel;
+}
+
+/* Full batches through the widest kernel, then 64-block batches, then
+ * the one-block function for the tail.
+ */
+static void
+crypt_ecb(uint32_t (*ks)[2], int stages, unsigned char *data, unsigned long count,
+	  void (*single)(uint32_t (*)[2], unsigned char *))
+{
+	const desbs_kernel *wide = wide_kernel();
+
+	while (wide->width > 64 && count >= (unsigned long)wide->width) {
+		wide->crypt(ks, stages, data);
+		data += wide->width*8;
+		count -= wide->width;
+	}
+	while (count >= 64) {
+		crypt_slices<SliceU64>(ks, stages, data);
+		data += 64*8;
+		count -= 64;
+	}
+	while (count > 0) {
+		single(ks, data);
+		data += 8;
+		count--;
+	}
+}
+
+} /* namespace */
+
+int
+desbs_width(void)
+{
+	return wide_kernel()->width;
+}
+
+void
+desbs(DES_KS ks, unsigned char *blocks)
+{
+	wide_kernel()->crypt(ks, 1, blocks);
+}
+
+void
+des3bs(DES3_KS ks, unsigned char *blocks)
+{
+	wide_kernel()->crypt(ks, 3, blocks);
+}
+
+void
+desecb(DES_KS ks, unsigned char *data, unsigned long count)
+{
+	crypt_ecb(ks, 1, data, count, des);
+}
+
+void
+des3ecb(DES3_KS ks, unsigned char *data, unsigned long count)
+{
+	crypt_ecb(ks, 3, data, count, des3);
+}
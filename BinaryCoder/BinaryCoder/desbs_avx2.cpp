@@ -0,0 +1,49 @@
+/* AVX2 slices for the bitsliced DES engine, 256 blocks per call.
+ *
+ * Built for AVX2 through a target attribute, not -mavx2, which the
+ * compiler would reject when building for arm64; desbs.cpp only calls
+ * it when the CPU has AVX2.
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define DESBS_HAVE_AVX2 1
+#define DESBS_TARGET __attribute__((target("avx2")))
+#endif
+
+#include "desbs_impl.h"
+
+#ifdef DESBS_HAVE_AVX2
+#include <immintrin.h>
+
+namespace {
+
+struct SliceAVX2 {
+	enum { Lanes = 4 };
+	__m256i v;
+	static DESBS_TARGET SliceAVX2 load(const uint64_t *p) { SliceAVX2 r = { _mm256_loadu_si256((const __m256i *)p) }; return r; }
+	static DESBS_TARGET SliceAVX2 splat(uint64_t x) { SliceAVX2 r = { _mm256_set1_epi64x((long long)x) }; return r; }
+	DESBS_TARGET void store(uint64_t *p) const { _mm256_storeu_si256((__m256i *)p, v); }
+};
+static inline DESBS_TARGET SliceAVX2 operator&(const SliceAVX2& a, const SliceAVX2& b) { SliceAVX2 r = { _mm256_and_si256(a.v, b.v) }; return r; }
+static inline DESBS_TARGET SliceAVX2 operator|(const SliceAVX2& a, const SliceAVX2& b) { SliceAVX2 r = { _mm256_or_si256(a.v, b.v) }; return r; }
+static inline DESBS_TARGET SliceAVX2 operator^(const SliceAVX2& a, const SliceAVX2& b) { SliceAVX2 r = { _mm256_xor_si256(a.v, b.v) }; return r; }
+static inline DESBS_TARGET SliceAVX2 andn(const SliceAVX2& a, const SliceAVX2& b) { SliceAVX2 r = { _mm256_andnot_si256(a.v, b.v) }; return r; }
+
+} /* namespace */
+
+const desbs_kernel *
+desbs_kernel_avx2(void)
+{
+	static const desbs_kernel kernel = { 64*SliceAVX2::Lanes, crypt_slices<SliceAVX2> };
+	return &kernel;
+}
+
+#else
+
+const desbs_kernel *
+desbs_kernel_avx2(void)
+{
+	return NULL;
+}
+
+#endif
@@ -0,0 +1,51 @@
+/* AVX-512 slices for the bitsliced DES engine, 512 blocks per call.
+ *
+ * Built for AVX-512 through a target attribute, not -mavx512f, which the
+ * compiler would reject when building for arm64; desbs.cpp only calls
+ * it when the CPU has AVX-512.
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define DESBS_HAVE_AVX512 1
+#define DESBS_TARGET __attribute__((target("avx512f")))
+#endif
+
+#include "desbs_impl.h"
+
+#ifdef DESBS_HAVE_AVX512
+#include <immintrin.h>
+
+namespace {
+
+struct SliceAVX512 {
+	enum { Lanes = 8 };
+	__m512i v;
+	static DESBS_TARGET SliceAVX512 load(const uint64_t *p) { SliceAVX512 r = { _mm512_loadu_si512((const void *)p) }; return r; }
+	static DESBS_TARGET SliceAVX512 splat(uint64_t x) { SliceAVX512 r = { _mm512_set1_epi64((long long)x) }; return r; }
+	DESBS_TARGET void store(uint64_t *p) const { _mm512_storeu_si512((void *)p, v); }
+};
+static inline DESBS_TARGET SliceAVX512 operator&(const SliceAVX512& a, const SliceAVX512& b) { SliceAVX512 r = { _mm512_and_si512(a.v, b.v) }; return r; }
+static inline DESBS_TARGET SliceAVX512 operator|(const SliceAVX512& a, const SliceAVX512& b) { SliceAVX512 r = { _mm512_or_si512(a.v, b.v) }; return r; }
+static inline DESBS_TARGET SliceAVX512 operator^(const SliceAVX512& a, const SliceAVX512& b) { SliceAVX512 r = { _mm512_xor_si512(a.v, b.v) }; return r; }
+/* ~a & b as a ternary logic function (0x0c): GCC's _mm512_andnot_si512 passes
+ * an uninitialized vector to its builtin, which -Wall reports. */
+static inline DESBS_TARGET SliceAVX512 andn(const SliceAVX512& a, const SliceAVX512& b) { SliceAVX512 r = { _mm512_ternarylogic_epi64(a.v, b.v, b.v, 0x0c) }; return r; }
+
+} /* namespace */
+
+const desbs_kernel *
+desbs_kernel_avx512(void)
+{
+	static const desbs_kernel kernel = { 64*SliceAVX512::Lanes, crypt_slices<SliceAVX512> };
+	return &kernel;
+}
+
+#else
+
+const desbs_kernel *
+desbs_kernel_avx512(void)
+{
+	return NULL;
+}
+
+#endif
@@ -0,0 +1,270 @@
+/* Shared part of the bitsliced DES engine, see desbs.cpp.
+ *
+ * Included by desbs.cpp and by the per-ISA files (desbs_sse2.cpp,
+ * desbs_avx2.cpp, desbs_avx512.cpp), each built for its own instruction
+ * set (see DESBS_TARGET). Everything here has internal linkage so every
+ * file gets its own copy built for its instruction set, and code compiled
+ * for AVX2 never runs on a CPU without it.
+ */
+
+#ifndef DESBS_IMPL_H_
+#define DESBS_IMPL_H_
+
+extern "C" {
+#include "des.h"
+}
+#include <string.h>
+#include <stdint.h>
+
+/* The target attribute of the slice code, defined by a per-ISA file before
+ * it includes this one. An attribute rather than a compiler flag such as
+ * -mavx2, which would also be passed when building for arm64.
+ */
+#ifndef DESBS_TARGET
+#define DESBS_TARGET
+#endif
+
+/* One slice width of the engine: crypt processes `width' blocks in place
+ * with `stages' chained DES operations (see crypt_slices below).
+ */
+struct desbs_kernel {
+	int width;
+	void (*crypt)(uint32_t (*ks)[2], int stages, unsigned char *blocks);
+};
+
+/* Kernels of the per-ISA files, NULL when the file was built without
+ * its instruction set. Whether the running CPU has it is up to the caller.
+ */
+const desbs_kernel *desbs_kernel_sse2(void);
+const desbs_kernel *desbs_kernel_avx2(void);
+const desbs_kernel *desbs_kernel_avx512(void);
+
+/* Tables defined in the Data Encryption Standard documents,
+ * see desport.c. Bits are numbered from 1 like in the FIPS.
+ */
+static const unsigned char ip[] = {
+	58, 50, 42, 34, 26, 18, 10,  2,
+	60, 52, 44, 36, 28, 20, 12,  4,
+	62, 54, 46, 38, 30, 22, 14,  6,
+	64, 56, 48, 40, 32, 24, 16,  8,
+	57, 49, 41, 33, 25, 17,  9,  1,
+	59, 51, 43, 35, 27, 19, 11,  3,
+	61, 53, 45, 37, 29, 21, 13,  5,
+	63, 55, 47, 39, 31, 23, 15,  7
+};
+
+static const unsigned char fp[] = {
+	40,  8, 48, 16, 56, 24, 64, 32,
+	39,  7, 47, 15, 55, 23, 63, 31,
+	38,  6, 46, 14, 54, 22, 62, 30,
+	37,  5, 45, 13, 53, 21, 61, 29,
+	36,  4, 44, 12, 52, 20, 60, 28,
+	35,  3, 43, 11, 51, 19, 59, 27,
+	34,  2, 42, 10, 50, 18, 58, 26,
+	33,  1, 41,  9, 49, 17, 57, 25
+};
+
+static const unsigned char ei[] = {
+	32,  1,  2,  3,  4,  5,
+	 4,  5,  6,  7,  8,  9,
+	 8,  9, 10, 11, 12, 13,
+	12, 13, 14, 15, 16, 17,
+	16, 17, 18, 19, 20, 21,
+	20, 21, 22, 23, 24, 25,
+	24, 25, 26, 27, 28, 29,
+	28, 29, 30, 31, 32,  1
+};
+
+/* Inverse of the 32-bit permutation P (p32i in desport.c), origin 0:
+ * output bit n of the S-boxes lands in bit pinv[n] of f(R,K).
+ */
+static const unsigned char pinv[] = {
+	 8, 16, 22, 30, 12, 27,  1, 17,
+	23, 15, 29,  5, 25, 19,  9,  0,
+	 7, 13, 24,  2,  3, 28, 10, 18,
+	31, 11, 21,  6,  4, 26, 14, 20
+};
+
+namespace {
+
+/* Slice types. Each one wraps a register holding Lanes 64-bit words and
+ * provides the few operators the S-box circuits need. The SIMD ones live
+ * in the per-ISA files.
+ */
+struct SliceU64 {
+	enum { Lanes = 1 };
+	uint64_t v;
+	static SliceU64 load(const uint64_t *p) { SliceU64 r; r.v = *p; return r; }
+	static SliceU64 splat(uint64_t x) { SliceU64 r; r.v = x; return r; }
+	void store(uint64_t *p) const { *p = v; }
+};
+static inline SliceU64 operator&(const SliceU64& a, const SliceU64& b) { SliceU64 r; r.v = a.v & b.v; return r; }
+static inline SliceU64 operator|(const SliceU64& a, const SliceU64& b) { SliceU64 r; r.v = a.v | b.v; return r; }
+static inline SliceU64 operator^(const SliceU64& a, const SliceU64& b) { SliceU64 r; r.v = a.v ^ b.v; return r; }
+static inline SliceU64 andn(const SliceU64& a, const SliceU64& b) { SliceU64 r; r.v = ~a.v & b.v; return r; }
+
+#include "desbs_sbox.h"
+
+/* Expand a key schedule into one all-zeros/all-ones mask per key bit,
+ * k[round][n] for the n-th (origin-0) bit of the 48-bit subkey.
+ * See deskey.c for the packed layout: the first word holds the 6-bit
+ * subkeys for S-boxes 1, 3, 5 & 7, the second those for 2, 4, 6 & 8, from
+ * high byte to low byte, each 6-bit subkey with its first bit at 0x20.
+ */
+static void
+expand_schedule(uint32_t (*ks)[2], uint64_t k[16][48])
+{
+	int i, s, j;
+
+	for (i = 0; i < 16; i++) {
+		for (s = 0; s < 8; s++) {
+			uint32_t word = ks[i][s & 1];
+			uint32_t chunk = (word >> (24 - 8*(s >> 1))) & 0x3f;
+			for (j = 0; j < 6; j++) {
+				k[i][6*s + j] = ((chunk >> (5 - j)) & 1) ? ~(uint64_t)0 : 0;
+			}
+		}
+	}
+}
+
+/* Transpose a 64x64 bit matrix in place. Row r, column c is bit (63-c)
+ * of a[r]; afterwards it is bit (63-r) of a[c].
+ */
+static void
+transpose64(uint64_t a[64])
+{
+	int j, k;
+	uint64_t m, t;
+
+	for (j = 32, m = 0x00000000ffffffffULL; j != 0; j >>= 1, m ^= m << j) {
+		for (k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+			t = (a[k] ^ (a[k | j] >> j)) & m;
+			a[k] ^= t;
+			a[k | j] ^= t << j;
+		}
+	}
+}
+
+/* Load 64 blocks per lane and turn them into slices:
+ * slices[i*Lanes + lane] holds FIPS bit i+1 of the blocks in that lane.
+ */
+static void
+to_slices(const unsigned char *blocks, uint64_t *slices, int lanes)
+{
+	uint64_t a[64];
+	int lane, b, i;
+
+	for (lane = 0; lane < lanes; lane++) {
+		const unsigned char *p = blocks + lane*64*8;
+		for (b = 0; b < 64; b++, p += 8) {
+			a[b] = ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48)
+			 | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32)
+			 | ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16)
+			 | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+		}
+		transpose64(a);
+		for (i = 0; i < 64; i++) {
+			slices[i*lanes + lane] = a[i];
+		}
+	}
+}
+
+static void
+from_slices(const uint64_t *slices, unsigned char *blocks, int lanes)
+{
+	uint64_t a[64];
+	int lane, b, i;
+
+	for (lane = 0; lane < lanes; lane++) {
+		unsigned char *p = blocks + lane*64*8;
+		for (i = 0; i < 64; i++) {
+			a[i] = slices[i*lanes + lane];
+		}
+		transpose64(a);
+		for (b = 0; b < 64; b++, p += 8) {
+			p[0] = (unsigned char)(a[b] >> 56);
+			p[1] = (unsigned char)(a[b] >> 48);
+			p[2] = (unsigned char)(a[b] >> 40);
+			p[3] = (unsigned char)(a[b] >> 32);
+			p[4] = (unsigned char)(a[b] >> 24);
+			p[5] = (unsigned char)(a[b] >> 16);
+			p[6] = (unsigned char)(a[b] >> 8);
+			p[7] = (unsigned char)a[b];
+		}
+	}
+}
+
+/* Primitive function F on slices: r is the 32-bit half fed through E,
+ * the S-boxes and P; the result is XORed into l.
+ */
+template <class V>
+static inline DESBS_TARGET void
+F(V l[32], const V r[32], const uint64_t key[48], const V& ones)
+{
+	V y[4];
+#define	SBOX(n, s) \
+	s(r[ei[6*n]-1] ^ V::splat(key[6*n]), r[ei[6*n+1]-1] ^ V::splat(key[6*n+1]), \
+	  r[ei[6*n+2]-1] ^ V::splat(key[6*n+2]), r[ei[6*n+3]-1] ^ V::splat(key[6*n+3]), \
+	  r[ei[6*n+4]-1] ^ V::splat(key[6*n+4]), r[ei[6*n+5]-1] ^ V::splat(key[6*n+5]), \
+	  ones, y); \
+	l[pinv[4*n]] = l[pinv[4*n]] ^ y[0]; \
+	l[pinv[4*n+1]] = l[pinv[4*n+1]] ^ y[1]; \
+	l[pinv[4*n+2]] = l[pinv[4*n+2]] ^ y[2]; \
+	l[pinv[4*n+3]] = l[pinv[4*n+3]] ^ y[3];
+	SBOX(0, s1)
+	SBOX(1, s2)
+	SBOX(2, s3)
+	SBOX(3, s4)
+	SBOX(4, s5)
+	SBOX(5, s6)
+	SBOX(6, s7)
+	SBOX(7, s8)
+#undef	SBOX
+}
+
+/* Encrypt or decrypt 64*V::Lanes blocks in place with `stages' chained
+ * DES operations, stage n using the 16 subkeys at ks[16*n]. For triple DES
+ * the FP/IP pair between two stages cancels out; all that is left is the
+ * swap of the halves, done here by swapping the roles of l and r.
+ */
+template <class V>
+static DESBS_TARGET void
+crypt_slices(uint32_t (*ks)[2], int stages, unsigned char *blocks)
+{
+	uint64_t k[16][48];
+	uint64_t slices[64*V::Lanes];
+	V l[32], r[32];
+	const V ones = V::splat(~(uint64_t)0);
+	int i, stage;
+
+	to_slices(blocks, slices, V::Lanes);
+
+	/* Initial permutation: just pick the slices in IP order */
+	for (i = 0; i < 32; i++) {
+		l[i] = V::load(&slices[(ip[i]-1)*V::Lanes]);
+		r[i] = V::load(&slices[(ip[32+i]-1)*V::Lanes]);
+	}
+
+	for (stage = 0; stage < stages; stage++) {
+		expand_schedule(&ks[16*stage], k);
+		V *a = (stage & 1) ? r : l;
+		V *b = (stage & 1) ? l : r;
+		for (i = 0; i < 16; i += 2) {
+			F(a, b, k[i], ones);
+			F(b, a, k[i+1], ones);
+		}
+	}
+
+	/* Final permutation of the swapped halves R16 L16 */
+	for (i = 0; i < 64; i++) {
+		int n = fp[i]-1;
+		const V& src = n < 32 ? r[n] : l[n-32];
+		src.store(&slices[i*V::Lanes]);
+	}
+
+	from_slices(slices, blocks, V::Lanes);
+}
+
+} /* namespace */
+
+#endif /* DESBS_IMPL_H_ */
@@ -0,0 +1,451 @@
+/* Generated by genbs.c
+ */
+
+/* S1 */
+template <class V>
+static inline DESBS_TARGET void s1(const V& x0, const V& x1, const V& x2,
+                                   const V& x3, const V& x4, const V& x5,
+                                   const V& ones, V y[4])
+{
+    const V r3 = x0 & x5;
+    const V r2 = andn(x5, x0);
+    const V r1 = andn(x0, x5);
+    const V r0 = andn(x0 | x5, ones);
+    const V p3 = x1 & x2;
+    const V p2 = andn(x2, x1);
+    const V p1 = andn(x1, x2);
+    const V p0 = andn(x1 | x2, ones);
+    const V q3 = x3 & x4;
+    const V q2 = andn(x4, x3);
+    const V q1 = andn(x3, x4);
+    const V q0 = andn(x3 | x4, ones);
+    const V c0 = p0 & q0;
+    const V c1 = p0 & q1;
+    const V c2 = p0 & q2;
+    const V c3 = p0 & q3;
+    const V c4 = p1 & q0;
+    const V c5 = p1 & q1;
+    const V c6 = p1 & q2;
+    const V c7 = p1 & q3;
+    const V c8 = p2 & q0;
+    const V c9 = p2 & q1;
+    const V c10 = p2 & q2;
+    const V c11 = p2 & q3;
+    const V c12 = p3 & q0;
+    const V c13 = p3 & q1;
+    const V c14 = p3 & q2;
+    const V c15 = p3 & q3;
+    const V g00 = c0 | c2 | c5 | c6 | c7 | c9 | c11 | c13;
+    const V g01 = c1 | c4 | c6 | c8 | c10 | c11 | c12 | c15;
+    const V g02 = c2 | c3 | c4 | c7 | c8 | c9 | c10 | c13;
+    const V g03 = c0 | c1 | c2 | c5 | c9 | c11 | c12 | c15;
+    y[0] = (r0 & g00) | (r1 & g01) | (r2 & g02) | (r3 & g03);
+    const V g10 = c0 | c1 | c2 | c5 | c10 | c11 | c12 | c15;
+    const V g11 = c1 | c2 | c3 | c4 | c6 | c9 | c10 | c13;
+    const V g12 = c0 | c2 | c4 | c5 | c8 | c9 | c11 | c14;
+    const V g13 = c0 | c1 | c4 | c7 | c8 | c11 | c14 | c15;
+    y[1] = (r0 & g10) | (r1 & g11) | (r2 & g12) | (r3 & g13);
+    const V g20 = c0 | c4 | c5 | c6 | c8 | c9 | c10 | c15;
+    const V g21 = c1 | c2 | c4 | c5 | c8 | c9 | c11 | c14;
+    const V g22 = c2 | c5 | c6 | c7 | c8 | c11 | c12 | c13;
+    const V g23 = c0 | c3 | c7 | c9 | c10 | c11 | c12 | c14;
+    y[2] = (r0 & g20) | (r1 & g21) | (r2 & g22) | (r3 & g23);
+    const V g30 = c2 | c3 | c5 | c6 | c8 | c12 | c13 | c15;
+    const V g31 = c1 | c2 | c6 | c7 | c11 | c12 | c13 | c14;
+    const V g32 = c1 | c4 | c7 | c8 | c10 | c11 | c12 | c14;
+    const V g33 = c0 | c5 | c6 | c7 | c8 | c9 | c10 | c15;
+    y[3] = (r0 & g30) | (r1 & g31) | (r2 & g32) | (r3 & g33);
+}
+
+/* S2 */
+template <class V>
+static inline DESBS_TARGET void s2(const V& x0, const V& x1, const V& x2,
+                                   const V& x3, const V& x4, const V& x5,
+                                   const V& ones, V y[4])
+{
+    const V r3 = x0 & x5;
+    const V r2 = andn(x5, x0);
+    const V r1 = andn(x0, x5);
+    const V r0 = andn(x0 | x5, ones);
+    const V p3 = x1 & x2;
+    const V p2 = andn(x2, x1);
+    const V p1 = andn(x1, x2);
+    const V p0 = andn(x1 | x2, ones);
+    const V q3 = x3 & x4;
+    const V q2 = andn(x4, x3);
+    const V q1 = andn(x3, x4);
+    const V q0 = andn(x3 | x4, ones);
+    const V c0 = p0 & q0;
+    const V c1 = p0 & q1;
+    const V c2 = p0 & q2;
+    const V c3 = p0 & q3;
+    const V c4 = p1 & q0;
+    const V c5 = p1 & q1;
+    const V c6 = p1 & q2;
+    const V c7 = p1 & q3;
+    const V c8 = p2 & q0;
+    const V c9 = p2 & q1;
+    const V c10 = p2 & q2;
+    const V c11 = p2 & q3;
+    const V c12 = p3 & q0;
+    const V c13 = p3 & q1;
+    const V c14 = p3 & q2;
+    const V c15 = p3 & q3;
+    const V g00 = c0 | c2 | c3 | c5 | c8 | c11 | c12 | c15;
+    const V g01 = c1 | c4 | c6 | c7 | c8 | c11 | c13 | c14;
+    const V g02 = c1 | c3 | c4 | c6 | c9 | c10 | c12 | c15;
+    const V g03 = c0 | c1 | c2 | c5 | c8 | c11 | c14 | c15;
+    y[0] = (r0 & g00) | (r1 & g01) | (r2 & g02) | (r3 & g03);
+    const V g10 = c0 | c3 | c4 | c7 | c9 | c11 | c12 | c14;
+    const V g11 = c1 | c2 | c3 | c4 | c7 | c8 | c12 | c15;
+    const V g12 = c1 | c2 | c5 | c6 | c8 | c10 | c11 | c15;
+    const V g13 = c0 | c5 | c6 | c9 | c10 | c11 | c13 | c14;
+    y[1] = (r0 & g10) | (r1 & g11) | (r2 & g12) | (r3 & g13);
+    const V g20 = c0 | c3 | c4 | c5 | c6 | c9 | c10 | c15;
+    const V g21 = c0 | c3 | c4 | c5 | c7 | c11 | c12 | c14;
+    const V g22 = c1 | c2 | c3 | c4 | c11 | c13 | c14 | c15;
+    const V g23 = c2 | c4 | c5 | c7 | c8 | c9 | c10 | c14;
+    y[2] = (r0 & g20) | (r1 & g21) | (r2 & g22) | (r3 & g23);
+    const V g30 = c0 | c1 | c5 | c6 | c8 | c9 | c11 | c14;
+    const V g31 = c0 | c1 | c3 | c4 | c10 | c13 | c14 | c15;
+    const V g32 = c2 | c3 | c6 | c7 | c8 | c12 | c13 | c15;
+    const V g33 = c0 | c3 | c4 | c5 | c8 | c10 | c13 | c15;
+    y[3] = (r0 & g30) | (r1 & g31) | (r2 & g32) | (r3 & g33);
+}
+
+/* S3 */
+template <class V>
+static inline DESBS_TARGET void s3(const V& x0, const V& x1, const V& x2,
+                                   const V& x3, const V& x4, const V& x5,
+                                   const V& ones, V y[4])
+{
+    const V r3 = x0 & x5;
+    const V r2 = andn(x5, x0);
+    const V r1 = andn(x0, x5);
+    const V r0 = andn(x0 | x5, ones);
+    const V p3 = x1 & x2;
+    const V p2 = andn(x2, x1);
+    const V p1 = andn(x1, x2);
+    const V p0 = andn(x1 | x2, ones);
+    const V q3 = x3 & x4;
+    const V q2 = andn(x4, x3);
+    const V q1 = andn(x3, x4);
+    const V q0 = andn(x3 | x4, ones);
+    const V c0 = p0 & q0;
+    const V c1 = p0 & q1;
+    const V c2 = p0 & q2;
+    const V c3 = p0 & q3;
+    const V c4 = p1 & q0;
+    const V c5 = p1 & q1;
+    const V c6 = p1 & q2;
+    const V c7 = p1 & q3;
+    const V c8 = p2 & q0;
+    const V c9 = p2 & q1;
+    const V c10 = p2 & q2;
+    const V c11 = p2 & q3;
+    const V c12 = p3 & q0;
+    const V c13 = p3 & q1;
+    const V c14 = p3 & q2;
+    const V c15 = p3 & q3;
+    const V g00 = c0 | c2 | c3 | c6 | c9 | c10 | c12 | c15;
+    const V g01 = c0 | c3 | c7 | c9 | c11 | c12 | c13 | c14;
+    const V g02 = c0 | c3 | c4 | c5 | c8 | c11 | c13 | c14;
+    const V g03 = c1 | c2 | c5 | c6 | c9 | c10 | c12 | c15;
+    y[0] = (r0 & g00) | (r1 & g01) | (r2 & g02) | (r3 & g03);
+    const V g10 = c3 | c4 | c6 | c7 | c9 | c10 | c11 | c13;
+    const V g11 = c0 | c1 | c5 | c6 | c10 | c11 | c12 | c14;
+    const V g12 = c0 | c1 | c2 | c5 | c11 | c12 | c14 | c15;
+    const V g13 = c2 | c4 | c7 | c8 | c9 | c10 | c13 | c15;
+    y[1] = (r0 & g10) | (r1 & g11) | (r2 & g12) | (r3 & g13);
+    const V g20 = c0 | c3 | c4 | c5 | c6 | c11 | c12 | c14;
+    const V g21 = c1 | c4 | c6 | c7 | c8 | c11 | c13 | c14;
+    const V g22 = c1 | c5 | c6 | c8 | c10 | c13 | c14 | c15;
+    const V g23 = c1 | c4 | c7 | c9 | c10 | c11 | c12 | c14;
+    y[2] = (r0 & g20) | (r1 & g21) | (r2 & g22) | (r3 & g23);
+    const V g30 = c2 | c5 | c6 | c7 | c8 | c9 | c11 | c12;
+    const V g31 = c0 | c1 | c3 | c4 | c10 | c13 | c14 | c15;
+    const V g32 = c0 | c3 | c5 | c6 | c8 | c9 | c12 | c15;
+    const V g33 = c0 | c2 | c5 | c7 | c9 | c11 | c12 | c13;
+    y[3] = (r0 & g30) | (r1 & g31) | (r2 & g32) | (r3 & g33);
+}
+
+/* S4 */
+template <class V>
+static inline DESBS_TARGET void s4(const V& x0, const V& x1, const V& x2,
+                                   const V& x3, const V& x4, const V& x5,
+                                   const V& ones, V y[4])
+{
+    const V r3 = x0 & x5;
+    const V r2 = andn(x5, x0);
+    const V r1 = andn(x0, x5);
+    const V r0 = andn(x0 | x5, ones);
+    const V p3 = x1 & x2;
+    const V p2 = andn(x2, x1);
+    const V p1 = andn(x1, x2);
+    const V p0 = andn(x1 | x2, ones);
+    const V q3 = x3 & x4;
+    const V q2 = andn(x4, x3);
+    const V q1 = andn(x3, x4);
+    const V q0 = andn(x3 | x4, ones);
+    const V c0 = p0 & q0;
+    const V c1 = p0 & q1;
+    const V c2 = p0 & q2;
+    const V c3 = p0 & q3;
+    const V c4 = p1 & q0;
+    const V c5 = p1 & q1;
+    const V c6 = p1 & q2;
+    const V c7 = p1 & q3;
+    const V c8 = p2 & q0;
+    const V c9 = p2 & q1;
+    const V c10 = p2 & q2;
+    const V c11 = p2 & q3;
+    const V c12 = p3 & q0;
+    const V c13 = p3 & q1;
+    const V c14 = p3 & q2;
+    const V c15 = p3 & q3;
+    const V g00 = c1 | c2 | c6 | c7 | c10 | c12 | c13 | c15;
+    const V g01 = c0 | c1 | c2 | c5 | c11 | c13 | c14 | c15;
+    const V g02 = c0 | c2 | c4 | c5 | c7 | c8 | c11 | c14;
+    const V g03 = c1 | c4 | c6 | c7 | c8 | c11 | c12 | c15;
+    y[0] = (r0 & g00) | (r1 & g01) | (r2 & g02) | (r3 & g03);
+    const V g10 = c0 | c1 | c2 | c5 | c11 | c13 | c14 | c15;
+    const V g11 = c0 | c3 | c4 | c5 | c8 | c9 | c11 | c14;
+    const V g12 = c1 | c4 | c6 | c7 | c8 | c11 | c12 | c15;
+    const V g13 = c1 | c3 | c6 | c9 | c10 | c12 | c13 | c15;
+    y[1] = (r0 & g10) | (r1 & g11) | (r2 & g12) | (r3 & g13);
+    const V g20 = c0 | c2 | c3 | c5 | c7 | c9 | c12 | c15;
+    const V g21 = c2 | c4 | c5 | c7 | c9 | c10 | c13 | c14;
+    const V g22 = c0 | c1 | c5 | c6 | c8 | c10 | c11 | c13;
+    const V g23 = c0 | c1 | c3 | c4 | c11 | c13 | c14 | c15;
+    y[2] = (r0 & g20) | (r1 & g21) | (r2 & g22) | (r3 & g23);
+    const V g30 = c0 | c1 | c3 | c6 | c8 | c11 | c12 | c15;
+    const V g31 = c0 | c2 | c3 | c5 | c7 | c9 | c12 | c15;
+    const V g32 = c2 | c5 | c6 | c7 | c8 | c9 | c10 | c12;
+    const V g33 = c0 | c1 | c5 | c6 | c8 | c10 | c11 | c13;
+    y[3] = (r0 & g30) | (r1 & g31) | (r2 & g32) | (r3 & g33);
+}
+
+/* S5 */
+template <class V>
+static inline DESBS_TARGET void s5(const V& x0, const V& x1, const V& x2,
+                                   const V& x3, const V& x4, const V& x5,
+                                   const V& ones, V y[4])
+{
+    const V r3 = x0 & x5;
+    const V r2 = andn(x5, x0);
+    const V r1 = andn(x0, x5);
+    const V r0 = andn(x0 | x5, ones);
+    const V p3 = x1 & x2;
+    const V p2 = andn(x2, x1);
+    const V p1 = andn(x1, x2);
+    const V p0 = andn(x1 | x2, ones);
+    const V q3 = x3 & x4;
+    const V q2 = andn(x4, x3);
+    const V q1 = andn(x3, x4);
+    const V q0 = andn(x3 | x4, ones);
+    const V c0 = p0 & q0;
+    const V c1 = p0 & q1;
+    const V c2 = p0 & q2;
+    const V c3 = p0 & q3;
+    const V c4 = p1 & q0;
+    const V c5 = p1 & q1;
+    const V c6 = p1 & q2;
+    const V c7 = p1 & q3;
+    const V c8 = p2 & q0;
+    const V c9 = p2 & q1;
+    const V c10 = p2 & q2;
+    const V c11 = p2 & q3;
+    const V c12 = p3 & q0;
+    const V c13 = p3 & q1;
+    const V c14 = p3 & q2;
+    const V c15 = p3 & q3;
+    const V g00 = c1 | c5 | c6 | c8 | c11 | c12 | c14 | c15;
+    const V g01 = c0 | c1 | c3 | c6 | c10 | c11 | c13 | c14;
+    const V g02 = c3 | c4 | c5 | c7 | c8 | c9 | c10 | c15;
+    const V g03 = c0 | c1 | c2 | c5 | c7 | c9 | c11 | c12;
+    y[0] = (r0 & g00) | (r1 & g01) | (r2 & g02) | (r3 & g03);
+    const V g10 = c1 | c2 | c4 | c7 | c9 | c11 | c12 | c14;
+    const V g11 = c0 | c3 | c4 | c5 | c6 | c8 | c10 | c15;
+    const V g12 = c0 | c5 | c6 | c8 | c10 | c11 | c12 | c15;
+    const V g13 = c2 | c3 | c5 | c7 | c8 | c9 | c13 | c14;
+    y[1] = (r0 & g10) | (r1 & g11) | (r2 & g12) | (r3 & g13);
+    const V g20 = c0 | c4 | c5 | c6 | c7 | c10 | c11 | c14;
+    const V g21 = c0 | c1 | c2 | c5 | c10 | c11 | c12 | c15;
+    const V g22 = c1 | c3 | c4 | c6 | c8 | c12 | c13 | c15;
+    const V g23 = c0 | c3 | c5 | c6 | c8 | c9 | c12 | c15;
+    y[2] = (r0 & g20) | (r1 & g21) | (r2 & g22) | (r3 & g23);
+    const V g30 = c3 | c4 | c6 | c9 | c10 | c11 | c12 | c15;
+    const V g31 = c1 | c5 | c6 | c7 | c8 | c10 | c12 | c13;
+    const V g32 = c2 | c3 | c5 | c6 | c8 | c9 | c11 | c13;
+    const V g33 = c0 | c3 | c4 | c7 | c9 | c11 | c14 | c15;
+    y[3] = (r0 & g30) | (r1 & g31) | (r2 & g32) | (r3 & g33);
+}
+
+/* S6 */
+template <class V>
+static inline DESBS_TARGET void s6(const V& x0, const V& x1, const V& x2,
+                                   const V& x3, const V& x4, const V& x5,
+                                   const V& ones, V y[4])
+{
+    const V r3 = x0 & x5;
+    const V r2 = andn(x5, x0);
+    const V r1 = andn(x0, x5);
+    const V r0 = andn(x0 | x5, ones);
+    const V p3 = x1 & x2;
+    const V p2 = andn(x2, x1);
+    const V p1 = andn(x1, x2);
+    const V p0 = andn(x1 | x2, ones);
+    const V q3 = x3 & x4;
+    const V q2 = andn(x4, x3);
+    const V q1 = andn(x3, x4);
+    const V q0 = andn(x3 | x4, ones);
+    const V c0 = p0 & q0;
+    const V c1 = p0 & q1;
+    const V c2 = p0 & q2;
+    const V c3 = p0 & q3;
+    const V c4 = p1 & q0;
+    const V c5 = p1 & q1;
+    const V c6 = p1 & q2;
+    const V c7 = p1 & q3;
+    const V c8 = p2 & q0;
+    const V c9 = p2 & q1;
+    const V c10 = p2 & q2;
+    const V c11 = p2 & q3;
+    const V c12 = p3 & q0;
+    const V c13 = p3 & q1;
+    const V c14 = p3 & q2;
+    const V c15 = p3 & q3;
+    const V g00 = c0 | c2 | c3 | c4 | c7 | c9 | c12 | c15;
+    const V g01 = c0 | c1 | c5 | c6 | c10 | c11 | c13 | c15;
+    const V g02 = c0 | c1 | c2 | c5 | c6 | c11 | c13 | c14;
+    const V g03 = c3 | c4 | c6 | c7 | c8 | c9 | c14 | c15;
+    y[0] = (r0 & g00) | (r1 & g01) | (r2 & g02) | (r3 & g03);
+    const V g10 = c0 | c3 | c6 | c9 | c11 | c12 | c13 | c14;
+    const V g11 = c1 | c2 | c4 | c5 | c7 | c8 | c10 | c11;
+    const V g12 = c1 | c2 | c3 | c6 | c8 | c10 | c13 | c15;
+    const V g13 = c0 | c3 | c5 | c6 | c9 | c11 | c12 | c15;
+    y[1] = (r0 & g10) | (r1 & g11) | (r2 & g12) | (r3 & g13);
+    const V g20 = c2 | c3 | c5 | c6 | c10 | c12 | c13 | c15;
+    const V g21 = c0 | c1 | c3 | c4 | c8 | c11 | c13 | c14;
+    const V g22 = c1 | c2 | c4 | c7 | c8 | c11 | c14 | c15;
+    const V g23 = c1 | c2 | c6 | c7 | c8 | c9 | c11 | c12;
+    y[2] = (r0 & g20) | (r1 & g21) | (r2 & g22) | (r3 & g23);
+    const V g30 = c1 | c3 | c4 | c9 | c10 | c13 | c14 | c15;
+    const V g31 = c1 | c4 | c6 | c7 | c9 | c10 | c13 | c14;
+    const V g32 = c0 | c2 | c3 | c7 | c8 | c12 | c13 | c14;
+    const V g33 = c1 | c4 | c5 | c6 | c8 | c10 | c11 | c15;
+    y[3] = (r0 & g30) | (r1 & g31) | (r2 & g32) | (r3 & g33);
+}
+
+/* S7 */
+template <class V>
+static inline DESBS_TARGET void s7(const V& x0, const V& x1, const V& x2,
+                                   const V& x3, const V& x4, const V& x5,
+                                   const V& ones, V y[4])
+{
+    const V r3 = x0 & x5;
+    const V r2 = andn(x5, x0);
+    const V r1 = andn(x0, x5);
+    const V r0 = andn(x0 | x5, ones);
+    const V p3 = x1 & x2;
+    const V p2 = andn(x2, x1);
+    const V p1 = andn(x1, x2);
+    const V p0 = andn(x1 | x2, ones);
+    const V q3 = x3 & x4;
+    const V q2 = andn(x4, x3);
+    const V q1 = andn(x3, x4);
+    const V q0 = andn(x3 | x4, ones);
+    const V c0 = p0 & q0;
+    const V c1 = p0 & q1;
+    const V c2 = p0 & q2;
+    const V c3 = p0 & q3;
+    const V c4 = p1 & q0;
+    const V c5 = p1 & q1;
+    const V c6 = p1 & q2;
+    const V c7 = p1 & q3;
+    const V c8 = p2 & q0;
+    const V c9 = p2 & q1;
+    const V c10 = p2 & q2;
+    const V c11 = p2 & q3;
+    const V c12 = p3 & q0;
+    const V c13 = p3 & q1;
+    const V c14 = p3 & q2;
+    const V c15 = p3 & q3;
+    const V g00 = c1 | c3 | c4 | c6 | c7 | c9 | c10 | c13;
+    const V g01 = c0 | c2 | c5 | c7 | c8 | c11 | c13 | c14;
+    const V g02 = c2 | c3 | c4 | c7 | c8 | c9 | c11 | c14;
+    const V g03 = c1 | c2 | c3 | c6 | c8 | c11 | c12 | c15;
+    y[0] = (r0 & g00) | (r1 & g01) | (r2 & g02) | (r3 & g03);
+    const V g10 = c0 | c3 | c4 | c7 | c9 | c11 | c12 | c14;
+    const V g11 = c0 | c3 | c4 | c8 | c10 | c11 | c13 | c15;
+    const V g12 = c1 | c3 | c4 | c6 | c7 | c9 | c10 | c13;
+    const V g13 = c0 | c2 | c5 | c7 | c9 | c11 | c12 | c15;
+    y[1] = (r0 & g10) | (r1 & g11) | (r2 & g12) | (r3 & g13);
+    const V g20 = c1 | c2 | c3 | c4 | c8 | c11 | c13 | c14;
+    const V g21 = c2 | c3 | c7 | c8 | c9 | c12 | c13 | c15;
+    const V g22 = c2 | c5 | c6 | c7 | c8 | c9 | c10 | c15;
+    const V g23 = c0 | c1 | c6 | c7 | c11 | c12 | c13 | c14;
+    y[2] = (r0 & g20) | (r1 & g21) | (r2 & g22) | (r3 & g23);
+    const V g30 = c1 | c4 | c7 | c8 | c10 | c11 | c12 | c15;
+    const V g31 = c0 | c2 | c3 | c5 | c6 | c9 | c10 | c13;
+    const V g32 = c0 | c2 | c3 | c5 | c6 | c9 | c13 | c14;
+    const V g33 = c1 | c2 | c4 | c7 | c8 | c9 | c11 | c14;
+    y[3] = (r0 & g30) | (r1 & g31) | (r2 & g32) | (r3 & g33);
+}
+
+/* S8 */
+template <class V>
+static inline DESBS_TARGET void s8(const V& x0, const V& x1, const V& x2,
+                                   const V& x3, const V& x4, const V& x5,
+                                   const V& ones, V y[4])
+{
+    const V r3 = x0 & x5;
+    const V r2 = andn(x5, x0);
+    const V r1 = andn(x0, x5);
+    const V r0 = andn(x0 | x5, ones);
+    const V p3 = x1 & x2;
+    const V p2 = andn(x2, x1);
+    const V p1 = andn(x1, x2);
+    const V p0 = andn(x1 | x2, ones);
+    const V q3 = x3 & x4;
+    const V q2 = andn(x4, x3);
+    const V q1 = andn(x3, x4);
+    const V q0 = andn(x3 | x4, ones);
+    const V c0 = p0 & q0;
+    const V c1 = p0 & q1;
+    const V c2 = p0 & q2;
+    const V c3 = p0 & q3;
+    const V c4 = p1 & q0;
+    const V c5 = p1 & q1;
+    const V c6 = p1 & q2;
+    const V c7 = p1 & q3;
+    const V c8 = p2 & q0;
+    const V c9 = p2 & q1;
+    const V c10 = p2 & q2;
+    const V c11 = p2 & q3;
+    const V c12 = p3 & q0;
+    const V c13 = p3 & q1;
+    const V c14 = p3 & q2;
+    const V c15 = p3 & q3;
+    const V g00 = c0 | c2 | c5 | c6 | c8 | c9 | c11 | c14;
+    const V g01 = c1 | c2 | c3 | c4 | c8 | c11 | c13 | c14;
+    const V g02 = c1 | c4 | c5 | c6 | c10 | c11 | c12 | c15;
+    const V g03 = c2 | c5 | c6 | c7 | c8 | c9 | c10 | c15;
+    y[0] = (r0 & g00) | (r1 & g01) | (r2 & g02) | (r3 & g03);
+    const V g10 = c0 | c3 | c4 | c5 | c11 | c12 | c14 | c15;
+    const V g11 = c1 | c2 | c6 | c7 | c8 | c9 | c10 | c13;
+    const V g12 = c0 | c2 | c5 | c6 | c9 | c11 | c12 | c14;
+    const V g13 = c2 | c3 | c4 | c7 | c8 | c9 | c13 | c14;
+    y[1] = (r0 & g10) | (r1 & g11) | (r2 & g12) | (r3 & g13);
+    const V g20 = c1 | c4 | c5 | c6 | c8 | c10 | c11 | c15;
+    const V g21 = c1 | c4 | c5 | c6 | c10 | c11 | c13 | c15;
+    const V g22 = c0 | c1 | c6 | c7 | c9 | c10 | c12 | c13;
+    const V g23 = c0 | c2 | c3 | c5 | c8 | c12 | c14 | c15;
+    y[2] = (r0 & g20) | (r1 & g21) | (r2 & g22) | (r3 & g23);
+    const V g30 = c0 | c5 | c6 | c7 | c9 | c10 | c12 | c15;
+    const V g31 = c0 | c1 | c2 | c5 | c6 | c9 | c11 | c14;
+    const V g32 = c0 | c1 | c3 | c4 | c11 | c12 | c13 | c14;
+    const V g33 = c1 | c3 | c7 | c8 | c10 | c12 | c13 | c15;
+    y[3] = (r0 & g30) | (r1 & g31) | (r2 & g32) | (r3 & g33);
+}
+
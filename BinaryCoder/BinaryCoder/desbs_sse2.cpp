@@ -0,0 +1,49 @@
+/* SSE2 slices for the bitsliced DES engine, 128 blocks per call.
+ *
+ * Built for SSE2 through a target attribute, not -msse2, which the
+ * compiler would reject when building for arm64; desbs.cpp only calls
+ * it when the CPU has SSE2.
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define DESBS_HAVE_SSE2 1
+#define DESBS_TARGET __attribute__((target("sse2")))
+#endif
+
+#include "desbs_impl.h"
+
+#ifdef DESBS_HAVE_SSE2
+#include <emmintrin.h>
+
+namespace {
+
+struct SliceSSE2 {
+	enum { Lanes = 2 };
+	__m128i v;
+	static DESBS_TARGET SliceSSE2 load(const uint64_t *p) { SliceSSE2 r = { _mm_loadu_si128((const __m128i *)p) }; return r; }
+	static DESBS_TARGET SliceSSE2 splat(uint64_t x) { SliceSSE2 r = { _mm_set1_epi64x((long long)x) }; return r; }
+	DESBS_TARGET void store(uint64_t *p) const { _mm_storeu_si128((__m128i *)p, v); }
+};
+static inline DESBS_TARGET SliceSSE2 operator&(const SliceSSE2& a, const SliceSSE2& b) { SliceSSE2 r = { _mm_and_si128(a.v, b.v) }; return r; }
+static inline DESBS_TARGET SliceSSE2 operator|(const SliceSSE2& a, const SliceSSE2& b) { SliceSSE2 r = { _mm_or_si128(a.v, b.v) }; return r; }
+static inline DESBS_TARGET SliceSSE2 operator^(const SliceSSE2& a, const SliceSSE2& b) { SliceSSE2 r = { _mm_xor_si128(a.v, b.v) }; return r; }
+static inline DESBS_TARGET SliceSSE2 andn(const SliceSSE2& a, const SliceSSE2& b) { SliceSSE2 r = { _mm_andnot_si128(a.v, b.v) }; return r; }
+
+} /* namespace */
+
+const desbs_kernel *
+desbs_kernel_sse2(void)
+{
+	static const desbs_kernel kernel = { 64*SliceSSE2::Lanes, crypt_slices<SliceSSE2> };
+	return &kernel;
+}
+
+#else
+
+const desbs_kernel *
+desbs_kernel_sse2(void)
+{
+	return NULL;
+}
+
+#endif
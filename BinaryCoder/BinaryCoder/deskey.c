@@ -1,6 +1,7 @@
 /* Portable C code to create DES key schedules from user-provided keys
- * This doesn't have to be fast unless you're cracking keys or UNIX
- * passwords
+ * The permuted choices run through nibble tables generated by genkey.c,
+ * so a schedule costs a few hundred table lookups rather than one test
+ * per key bit
  */
 
 #include <string.h>
@@ -8,44 +9,18 @@
 
 /* Key schedule-related tables from FIPS-46 */
 
-/* permuted choice table (key) */
-static unsigned char pc1[] = {
-	57, 49, 41, 33, 25, 17,  9,
-	 1, 58, 50, 42, 34, 26, 18,
-	10,  2, 59, 51, 43, 35, 27,
-	19, 11,  3, 60, 52, 44, 36,
-
-	63, 55, 47, 39, 31, 23, 15,
-	 7, 62, 54, 46, 38, 30, 22,
-	14,  6, 61, 53, 45, 37, 29,
-	21, 13,  5, 28, 20, 12,  4
-};
-
 /* number left rotations of pc1 */
 static unsigned char totrot[] = {
 	1,2,4,6,8,10,12,14,15,17,19,21,23,25,27,28
 };
 
-/* permuted choice key (table) */
-static unsigned char pc2[] = {
-	14, 17, 11, 24,  1,  5,
-	 3, 28, 15,  6, 21, 10,
-	23, 19, 12,  4, 26,  8,
-	16,  7, 27, 20, 13,  2,
-	41, 52, 31, 37, 47, 55,
-	30, 40, 51, 45, 33, 48,
-	44, 49, 39, 56, 34, 53,
-	46, 42, 50, 36, 29, 32
-};
-
 /* End of DES-defined tables */
 
+/* PC1 and PC2 expanded into nibble lookup tables */
+#include "deskey_tab.h"
 
-/* bit 0 is left-most in byte */
-static int bytebit[] = {
-	0200,0100,040,020,010,04,02,01
-};
-
+/* Rotate a 28-bit half of the key left by n bits */
+#define ROT28(x,n)	((((x) << (n)) | ((x) >> (28 - (n)))) & 0x0fffffff)
 
 /* Generate key schedule for encryption or decryption
  * depending on the value of "decrypt"
@@ -57,41 +32,29 @@ deskey(
        int decrypt          /* 0 = encrypt, 1 = decrypt */
        )	
 {
-	unsigned char pc1m[56];		/* place to modify pc1 into */
-	unsigned char pcr[56];		/* place to rotate pc1 into */
-	register int i,j,l;
-	int m;
-	unsigned char ks[8];
+	register uint32_t c,d,k0,k1;
+	register int i,j;
+	uint32_t c0 = 0, d0 = 0;
+	int r;
 
-	for (j=0; j<56; j++) {		/* convert pc1 to bits of key */
-		l=pc1[j]-1;		/* integer bit location	 */
-		m = l & 07;		/* find bit		 */
-		pc1m[j]=(key[l>>3] &	/* find which key byte l is in */
-			bytebit[m])	/* and which bit of that byte */
-			? 1 : 0;	/* and store 1-bit result */
+	for (j=0; j<8; j++) {		/* PC1, a nibble at a time */
+		c0 |= pc1c[2*j][key[j] >> 4] | pc1c[2*j+1][key[j] & 0xf];
+		d0 |= pc1d[2*j][key[j] >> 4] | pc1d[2*j+1][key[j] & 0xf];
 	}
 	for (i=0; i<16; i++) {		/* key chunk for each iteration */
-		memset(ks,0,sizeof(ks));	/* Clear key schedule */
-		for (j=0; j<56; j++)	/* rotate pc1 the right amount */
-			pcr[j] = pc1m[(l=j+totrot[decrypt? 15-i : i])<(j<28? 28 : 56) ? l: l-28];
-			/* rotate left and right halves independently */
-		for (j=0; j<48; j++){	/* select bits individually */
-			/* check bit that goes to ks[j] */
-			if (pcr[pc2[j]-1]){
-				/* mask it in if it's there */
-				l= j % 6;
-				ks[j/6] |= bytebit[l] >> 2;
-			}
+		r = totrot[decrypt? 15-i : i];
+		c = ROT28(c0, r);
+		d = ROT28(d0, r);
+		k0 = k1 = 0;
+		for (j=0; j<7; j++) {	/* PC2, a nibble of C and D at a time */
+			k0 |= pc2c[j][(c >> (24 - 4*j)) & 0xf][0]
+			    | pc2d[j][(d >> (24 - 4*j)) & 0xf][0];
+			k1 |= pc2c[j][(c >> (24 - 4*j)) & 0xf][1]
+			    | pc2d[j][(d >> (24 - 4*j)) & 0xf][1];
 		}
-		/* Now convert to packed odd/even interleaved form */
-		k[i][0] = ((long)ks[0] << 24)
-		 | ((long)ks[2] << 16)
-		 | ((long)ks[4] << 8)
-		 | ((long)ks[6]);
-		k[i][1] = ((long)ks[1] << 24)
-		 | ((long)ks[3] << 16)
-		 | ((long)ks[5] << 8)
-		 | ((long)ks[7]);
+		/* Packed odd/even interleaved form, as before */
+		k[i][0] = k0;
+		k[i][1] = k1;
 		if(Asmversion){
 			/* The assembler versions pre-shift each subkey 2 bits
 			 * so the Spbox indexes are already computed
@@ -0,0 +1,347 @@
+/* Generated by genkey.c
+ */
+
+static const uint32_t pc1c[16][16] = {
+    {
+        0x00000000,0x00000000,0x00000010,0x00000010,
+        0x00001000,0x00001000,0x00001010,0x00001010,
+        0x00100000,0x00100000,0x00100010,0x00100010,
+        0x00101000,0x00101000,0x00101010,0x00101010,
+    },
+    {
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+    },
+    {
+        0x00000000,0x00000000,0x00000020,0x00000020,
+        0x00002000,0x00002000,0x00002020,0x00002020,
+        0x00200000,0x00200000,0x00200020,0x00200020,
+        0x00202000,0x00202000,0x00202020,0x00202020,
+    },
+    {
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+    },
+    {
+        0x00000000,0x00000000,0x00000040,0x00000040,
+        0x00004000,0x00004000,0x00004040,0x00004040,
+        0x00400000,0x00400000,0x00400040,0x00400040,
+        0x00404000,0x00404000,0x00404040,0x00404040,
+    },
+    {
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+    },
+    {
+        0x00000000,0x00000000,0x00000080,0x00000080,
+        0x00008000,0x00008000,0x00008080,0x00008080,
+        0x00800000,0x00800000,0x00800080,0x00800080,
+        0x00808000,0x00808000,0x00808080,0x00808080,
+    },
+    {
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+    },
+    {
+        0x00000000,0x00000001,0x00000100,0x00000101,
+        0x00010000,0x00010001,0x00010100,0x00010101,
+        0x01000000,0x01000001,0x01000100,0x01000101,
+        0x01010000,0x01010001,0x01010100,0x01010101,
+    },
+    {
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+    },
+    {
+        0x00000000,0x00000002,0x00000200,0x00000202,
+        0x00020000,0x00020002,0x00020200,0x00020202,
+        0x02000000,0x02000002,0x02000200,0x02000202,
+        0x02020000,0x02020002,0x02020200,0x02020202,
+    },
+    {
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+    },
+    {
+        0x00000000,0x00000004,0x00000400,0x00000404,
+        0x00040000,0x00040004,0x00040400,0x00040404,
+        0x04000000,0x04000004,0x04000400,0x04000404,
+        0x04040000,0x04040004,0x04040400,0x04040404,
+    },
+    {
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+    },
+    {
+        0x00000000,0x00000008,0x00000800,0x00000808,
+        0x00080000,0x00080008,0x00080800,0x00080808,
+        0x08000000,0x08000008,0x08000800,0x08000808,
+        0x08080000,0x08080008,0x08080800,0x08080808,
+    },
+    {
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+    },
+};
+
+static const uint32_t pc1d[16][16] = {
+    {
+        0x00000000,0x00000001,0x00000000,0x00000001,
+        0x00000000,0x00000001,0x00000000,0x00000001,
+        0x00000000,0x00000001,0x00000000,0x00000001,
+        0x00000000,0x00000001,0x00000000,0x00000001,
+    },
+    {
+        0x00000000,0x00000000,0x00100000,0x00100000,
+        0x00001000,0x00001000,0x00101000,0x00101000,
+        0x00000010,0x00000010,0x00100010,0x00100010,
+        0x00001010,0x00001010,0x00101010,0x00101010,
+    },
+    {
+        0x00000000,0x00000002,0x00000000,0x00000002,
+        0x00000000,0x00000002,0x00000000,0x00000002,
+        0x00000000,0x00000002,0x00000000,0x00000002,
+        0x00000000,0x00000002,0x00000000,0x00000002,
+    },
+    {
+        0x00000000,0x00000000,0x00200000,0x00200000,
+        0x00002000,0x00002000,0x00202000,0x00202000,
+        0x00000020,0x00000020,0x00200020,0x00200020,
+        0x00002020,0x00002020,0x00202020,0x00202020,
+    },
+    {
+        0x00000000,0x00000004,0x00000000,0x00000004,
+        0x00000000,0x00000004,0x00000000,0x00000004,
+        0x00000000,0x00000004,0x00000000,0x00000004,
+        0x00000000,0x00000004,0x00000000,0x00000004,
+    },
+    {
+        0x00000000,0x00000000,0x00400000,0x00400000,
+        0x00004000,0x00004000,0x00404000,0x00404000,
+        0x00000040,0x00000040,0x00400040,0x00400040,
+        0x00004040,0x00004040,0x00404040,0x00404040,
+    },
+    {
+        0x00000000,0x00000008,0x00000000,0x00000008,
+        0x00000000,0x00000008,0x00000000,0x00000008,
+        0x00000000,0x00000008,0x00000000,0x00000008,
+        0x00000000,0x00000008,0x00000000,0x00000008,
+    },
+    {
+        0x00000000,0x00000000,0x00800000,0x00800000,
+        0x00008000,0x00008000,0x00808000,0x00808000,
+        0x00000080,0x00000080,0x00800080,0x00800080,
+        0x00008080,0x00008080,0x00808080,0x00808080,
+    },
+    {
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+    },
+    {
+        0x00000000,0x00000000,0x01000000,0x01000000,
+        0x00010000,0x00010000,0x01010000,0x01010000,
+        0x00000100,0x00000100,0x01000100,0x01000100,
+        0x00010100,0x00010100,0x01010100,0x01010100,
+    },
+    {
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+    },
+    {
+        0x00000000,0x00000000,0x02000000,0x02000000,
+        0x00020000,0x00020000,0x02020000,0x02020000,
+        0x00000200,0x00000200,0x02000200,0x02000200,
+        0x00020200,0x00020200,0x02020200,0x02020200,
+    },
+    {
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+    },
+    {
+        0x00000000,0x00000000,0x04000000,0x04000000,
+        0x00040000,0x00040000,0x04040000,0x04040000,
+        0x00000400,0x00000400,0x04000400,0x04000400,
+        0x00040400,0x00040400,0x04040400,0x04040400,
+    },
+    {
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+        0x00000000,0x00000000,0x00000000,0x00000000,
+    },
+    {
+        0x00000000,0x00000000,0x08000000,0x08000000,
+        0x00080000,0x00080000,0x08080000,0x08080000,
+        0x00000800,0x00000800,0x08000800,0x08000800,
+        0x00080800,0x00080800,0x08080800,0x08080800,
+    },
+};
+
+static const uint32_t pc2c[7][16][2] = {
+    {
+        {0x00000000,0x00000000},{0x00040000,0x00000000},
+        {0x00000000,0x20000000},{0x00040000,0x20000000},
+        {0x00000000,0x00010000},{0x00040000,0x00010000},
+        {0x00000000,0x20010000},{0x00040000,0x20010000},
+        {0x02000000,0x00000000},{0x02040000,0x00000000},
+        {0x02000000,0x20000000},{0x02040000,0x20000000},
+        {0x02000000,0x00010000},{0x02040000,0x00010000},
+        {0x02000000,0x20010000},{0x02040000,0x20010000},
+    },
+    {
+        {0x00000000,0x00000000},{0x00010000,0x00000000},
+        {0x00000000,0x00100000},{0x00010000,0x00100000},
+        {0x00000000,0x04000000},{0x00010000,0x04000000},
+        {0x00000000,0x04100000},{0x00010000,0x04100000},
+        {0x01000000,0x00000000},{0x01010000,0x00000000},
+        {0x01000000,0x00100000},{0x01010000,0x00100000},
+        {0x01000000,0x04000000},{0x01010000,0x04000000},
+        {0x01000000,0x04100000},{0x01010000,0x04100000},
+    },
+    {
+        {0x00000000,0x00000000},{0x00080000,0x00000000},
+        {0x08000000,0x00000000},{0x08080000,0x00000000},
+        {0x00000000,0x01000000},{0x00080000,0x01000000},
+        {0x08000000,0x01000000},{0x08080000,0x01000000},
+        {0x00000000,0x00000000},{0x00080000,0x00000000},
+        {0x08000000,0x00000000},{0x08080000,0x00000000},
+        {0x00000000,0x01000000},{0x00080000,0x01000000},
+        {0x08000000,0x01000000},{0x08080000,0x01000000},
+    },
+    {
+        {0x00000000,0x00000000},{0x00000000,0x00200000},
+        {0x00000000,0x08000000},{0x00000000,0x08200000},
+        {0x20000000,0x00000000},{0x20000000,0x00200000},
+        {0x20000000,0x08000000},{0x20000000,0x08200000},
+        {0x00000000,0x00020000},{0x00000000,0x00220000},
+        {0x00000000,0x08020000},{0x00000000,0x08220000},
+        {0x20000000,0x00020000},{0x20000000,0x00220000},
+        {0x20000000,0x08020000},{0x20000000,0x08220000},
+    },
+    {
+        {0x00000000,0x00000000},{0x00000000,0x00040000},
+        {0x00100000,0x00000000},{0x00100000,0x00040000},
+        {0x00000000,0x00000000},{0x00000000,0x00040000},
+        {0x00100000,0x00000000},{0x00100000,0x00040000},
+        {0x10000000,0x00000000},{0x10000000,0x00040000},
+        {0x10100000,0x00000000},{0x10100000,0x00040000},
+        {0x10000000,0x00000000},{0x10000000,0x00040000},
+        {0x10100000,0x00000000},{0x10100000,0x00040000},
+    },
+    {
+        {0x00000000,0x00000000},{0x04000000,0x00000000},
+        {0x00200000,0x00000000},{0x04200000,0x00000000},
+        {0x00000000,0x00000000},{0x04000000,0x00000000},
+        {0x00200000,0x00000000},{0x04200000,0x00000000},
+        {0x00000000,0x02000000},{0x04000000,0x02000000},
+        {0x00200000,0x02000000},{0x04200000,0x02000000},
+        {0x00000000,0x02000000},{0x04000000,0x02000000},
+        {0x00200000,0x02000000},{0x04200000,0x02000000},
+    },
+    {
+        {0x00000000,0x00000000},{0x00000000,0x10000000},
+        {0x00000000,0x00080000},{0x00000000,0x10080000},
+        {0x00020000,0x00000000},{0x00020000,0x10000000},
+        {0x00020000,0x00080000},{0x00020000,0x10080000},
+        {0x00000000,0x00000000},{0x00000000,0x10000000},
+        {0x00000000,0x00080000},{0x00000000,0x10080000},
+        {0x00020000,0x00000000},{0x00020000,0x10000000},
+        {0x00020000,0x00080000},{0x00020000,0x10080000},
+    },
+};
+
+static const uint32_t pc2d[7][16][2] = {
+    {
+        {0x00000000,0x00000000},{0x00000000,0x00000001},
+        {0x00000800,0x00000000},{0x00000800,0x00000001},
+        {0x00000000,0x00002000},{0x00000000,0x00002001},
+        {0x00000800,0x00002000},{0x00000800,0x00002001},
+        {0x00000000,0x00000002},{0x00000000,0x00000003},
+        {0x00000800,0x00000002},{0x00000800,0x00000003},
+        {0x00000000,0x00002002},{0x00000000,0x00002003},
+        {0x00000800,0x00002002},{0x00000800,0x00002003},
+    },
+    {
+        {0x00000000,0x00000000},{0x00000000,0x00000004},
+        {0x00000000,0x00000000},{0x00000000,0x00000004},
+        {0x00000002,0x00000000},{0x00000002,0x00000004},
+        {0x00000002,0x00000000},{0x00000002,0x00000004},
+        {0x00000000,0x00000200},{0x00000000,0x00000204},
+        {0x00000000,0x00000200},{0x00000000,0x00000204},
+        {0x00000002,0x00000200},{0x00000002,0x00000204},
+        {0x00000002,0x00000200},{0x00000002,0x00000204},
+    },
+    {
+        {0x00000000,0x00000000},{0x00000000,0x00001000},
+        {0x00000008,0x00000000},{0x00000008,0x00001000},
+        {0x00000000,0x00000000},{0x00000000,0x00001000},
+        {0x00000008,0x00000000},{0x00000008,0x00001000},
+        {0x00000400,0x00000000},{0x00000400,0x00001000},
+        {0x00000408,0x00000000},{0x00000408,0x00001000},
+        {0x00000400,0x00000000},{0x00000400,0x00001000},
+        {0x00000408,0x00000000},{0x00000408,0x00001000},
+    },
+    {
+        {0x00000000,0x00000000},{0x00000020,0x00000000},
+        {0x00000000,0x00000000},{0x00000020,0x00000000},
+        {0x00000000,0x00000010},{0x00000020,0x00000010},
+        {0x00000000,0x00000010},{0x00000020,0x00000010},
+        {0x00002000,0x00000000},{0x00002020,0x00000000},
+        {0x00002000,0x00000000},{0x00002020,0x00000000},
+        {0x00002000,0x00000010},{0x00002020,0x00000010},
+        {0x00002000,0x00000010},{0x00002020,0x00000010},
+    },
+    {
+        {0x00000000,0x00000000},{0x00000000,0x00000100},
+        {0x00000200,0x00000000},{0x00000200,0x00000100},
+        {0x00000000,0x00000020},{0x00000000,0x00000120},
+        {0x00000200,0x00000020},{0x00000200,0x00000120},
+        {0x00000000,0x00000400},{0x00000000,0x00000500},
+        {0x00000200,0x00000400},{0x00000200,0x00000500},
+        {0x00000000,0x00000420},{0x00000000,0x00000520},
+        {0x00000200,0x00000420},{0x00000200,0x00000520},
+    },
+    {
+        {0x00000000,0x00000000},{0x00001000,0x00000000},
+        {0x00000000,0x00000800},{0x00001000,0x00000800},
+        {0x00000000,0x00000008},{0x00001000,0x00000008},
+        {0x00000000,0x00000808},{0x00001000,0x00000808},
+        {0x00000010,0x00000000},{0x00001010,0x00000000},
+        {0x00000010,0x00000800},{0x00001010,0x00000800},
+        {0x00000010,0x00000008},{0x00001010,0x00000008},
+        {0x00000010,0x00000808},{0x00001010,0x00000808},
+    },
+    {
+        {0x00000000,0x00000000},{0x00000004,0x00000000},
+        {0x00000100,0x00000000},{0x00000104,0x00000000},
+        {0x00000000,0x00000000},{0x00000004,0x00000000},
+        {0x00000100,0x00000000},{0x00000104,0x00000000},
+        {0x00000001,0x00000000},{0x00000005,0x00000000},
+        {0x00000101,0x00000000},{0x00000105,0x00000000},
+        {0x00000001,0x00000000},{0x00000005,0x00000000},
+        {0x00000101,0x00000000},{0x00000105,0x00000000},
+    },
+};
+
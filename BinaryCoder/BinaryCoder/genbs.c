@@ -0,0 +1,136 @@
+/* This program produces C++ source containing the DES S-boxes as
+ * boolean circuits, for use by the bitsliced DES engine in desbs.cpp.
+ *
+ * Usage: genbs > desbs_sbox.h
+ *
+ * In a bitsliced implementation every variable holds one bit position of
+ * many different blocks, so a table lookup is not possible; each S-box has
+ * to be evaluated with AND/OR/ANDNOT gates instead. The circuits emitted
+ * here are a straightforward sum-of-minterms form:
+ *
+ *   - the 16 minterms of the four "column" bits (input bits 2..5) and the
+ *     4 minterms of the two "row" bits (input bits 1 and 6) are built once;
+ *   - for every row and output bit, the 8 columns that produce a 1 are ORed
+ *     together (each row of a DES S-box is a permutation of 0..15, so every
+ *     output bit is set in exactly half of the columns);
+ *   - the four row results are then selected by the row minterms.
+ *
+ * That is about 170 gates per S-box, shared by all blocks in a slice.
+ *
+ * The emitted functions are templates over the slice type V, which must
+ * provide the &, | and ^ operators and andn(a, b) == (~a & b). They are
+ * marked DESBS_TARGET, to be built for the instruction set of V (see
+ * desbs_impl.h).
+ */
+
+#include <stdio.h>
+
+/* The (in)famous S-boxes */
+static unsigned char sbox[8][64] = {
+	/* S1 */
+	14,  4, 13,  1,  2, 15, 11,  8,  3, 10,  6, 12,  5,  9,  0,  7,
+	 0, 15,  7,  4, 14,  2, 13,  1, 10,  6, 12, 11,  9,  5,  3,  8,
+	 4,  1, 14,  8, 13,  6,  2, 11, 15, 12,  9,  7,  3, 10,  5,  0,
+	15, 12,  8,  2,  4,  9,  1,  7,  5, 11,  3, 14, 10,  0,  6, 13,
+
+	/* S2 */
+	15,  1,  8, 14,  6, 11,  3,  4,  9,  7,  2, 13, 12,  0,  5, 10,
+	 3, 13,  4,  7, 15,  2,  8, 14, 12,  0,  1, 10,  6,  9, 11,  5,
+	 0, 14,  7, 11, 10,  4, 13,  1,  5,  8, 12,  6,  9,  3,  2, 15,
+	13,  8, 10,  1,  3, 15,  4,  2, 11,  6,  7, 12,  0,  5, 14,  9,
+
+	/* S3 */
+	10,  0,  9, 14,  6,  3, 15,  5,  1, 13, 12,  7, 11,  4,  2,  8,
+	13,  7,  0,  9,  3,  4,  6, 10,  2,  8,  5, 14, 12, 11, 15,  1,
+	13,  6,  4,  9,  8, 15,  3,  0, 11,  1,  2, 12,  5, 10, 14,  7,
+	 1, 10, 13,  0,  6,  9,  8,  7,  4, 15, 14,  3, 11,  5,  2, 12,
+
+	/* S4 */
+	 7, 13, 14,  3,  0,  6,  9, 10,  1,  2,  8,  5, 11, 12,  4, 15,
+	13,  8, 11,  5,  6, 15,  0,  3,  4,  7,  2, 12,  1, 10, 14,  9,
+	10,  6,  9,  0, 12, 11,  7, 13, 15,  1,  3, 14,  5,  2,  8,  4,
+	 3, 15,  0,  6, 10,  1, 13,  8,  9,  4,  5, 11, 12,  7,  2, 14,
+
+	/* S5 */
+	 2, 12,  4,  1,  7, 10, 11,  6,  8,  5,  3, 15, 13,  0, 14,  9,
+	14, 11,  2, 12,  4,  7, 13,  1,  5,  0, 15, 10,  3,  9,  8,  6,
+	 4,  2,  1, 11, 10, 13,  7,  8, 15,  9, 12,  5,  6,  3,  0, 14,
+	11,  8, 12,  7,  1, 14,  2, 13,  6, 15,  0,  9, 10,  4,  5,  3,
+
+	/* S6 */
+	12,  1, 10, 15,  9,  2,  6,  8,  0, 13,  3,  4, 14,  7,  5, 11,
+	10, 15,  4,  2,  7, 12,  9,  5,  6,  1, 13, 14,  0, 11,  3,  8,
+	 9, 14, 15,  5,  2,  8, 12,  3,  7,  0,  4, 10,  1, 13, 11,  6,
+	 4,  3,  2, 12,  9,  5, 15, 10, 11, 14,  1,  7,  6,  0,  8, 13,
+
+	/* S7 */
+	 4, 11,  2, 14, 15,  0,  8, 13,  3, 12,  9,  7,  5, 10,  6,  1,
+	13,  0, 11,  7,  4,  9,  1, 10, 14,  3,  5, 12,  2, 15,  8,  6,
+	 1,  4, 11, 13, 12,  3,  7, 14, 10, 15,  6,  8,  0,  5,  9,  2,
+	 6, 11, 13,  8,  1,  4, 10,  7,  9,  5,  0, 15, 14,  2,  3, 12,
+
+	/* S8 */
+	13,  2,  8,  4,  6, 15, 11,  1, 10,  9,  3, 14,  5,  0, 12,  7,
+	 1, 15, 13,  8, 10,  3,  7,  4, 12,  5,  6, 11,  0, 14,  9,  2,
+	 7, 11,  4,  1,  9, 12, 14,  2,  0,  6, 10, 13, 15,  3,  5,  8,
+	 2,  1, 14,  7,  4, 10,  8, 13, 15, 12,  9,  0,  3,  5,  6, 11
+};
+
+/* Emit the minterms of two inputs a and b into m<prefix>0..3,
+ * where minterm n is true when (a,b) == (n>>1, n&1).
+ */
+static void
+minterms2(const char *prefix, const char *a, const char *b)
+{
+	printf("    const V %s3 = %s & %s;\n", prefix, a, b);
+	printf("    const V %s2 = andn(%s, %s);\n", prefix, b, a);
+	printf("    const V %s1 = andn(%s, %s);\n", prefix, a, b);
+	printf("    const V %s0 = andn(%s | %s, ones);\n", prefix, a, b);
+}
+
+static void
+gen(int s)
+{
+	int col, row, bit, first;
+
+	printf("/* S%d */\n", s + 1);
+	printf("template <class V>\n");
+	printf("static inline DESBS_TARGET void s%d(const V& x0, const V& x1, const V& x2,\n", s + 1);
+	printf("                                   const V& x3, const V& x4, const V& x5,\n");
+	printf("                                   const V& ones, V y[4])\n");
+	printf("{\n");
+	minterms2("r", "x0", "x5");
+	minterms2("p", "x1", "x2");
+	minterms2("q", "x3", "x4");
+	for (col = 0; col < 16; col++) {
+		printf("    const V c%d = p%d & q%d;\n", col, col >> 2, col & 3);
+	}
+	for (bit = 0; bit < 4; bit++) {
+		for (row = 0; row < 4; row++) {
+			printf("    const V g%d%d = ", bit, row);
+			first = 1;
+			for (col = 0; col < 16; col++) {
+				if (sbox[s][row*16 + col] & (8 >> bit)) {
+					printf(first ? "c%d" : " | c%d", col);
+					first = 0;
+				}
+			}
+			printf(";\n");
+		}
+		printf("    y[%d] = (r0 & g%d0) | (r1 & g%d1) | (r2 & g%d2) | (r3 & g%d3);\n",
+		       bit, bit, bit, bit, bit);
+	}
+	printf("}\n\n");
+}
+
+int
+main(void)
+{
+	int s;
+
+	printf("/* Generated by genbs.c\n */\n\n");
+	for (s = 0; s < 8; s++) {
+		gen(s);
+	}
+	return 0;
+}
@@ -0,0 +1,123 @@
+/* This program produces C source containing the lookup tables used by
+ * deskey() to build DES key schedules a nibble at a time.
+ *
+ * Usage: genkey > deskey_tab.h
+ *
+ * PC1 splits the 56 key bits into two 28-bit halves C and D. Every key
+ * nibble lands in fixed bit positions of C and D, so PC1 becomes 16 table
+ * lookups (one per nibble of the 8 key bytes) ORed together.
+ *
+ * After the per-round rotation, PC2 picks the 24 subkey bits of the even
+ * and odd 6-bit groups from C and D. Again every nibble of C or D maps to
+ * fixed bits of the packed subkey words k[i][0] and k[i][1], so each round
+ * costs 14 lookups instead of 48 single-bit tests.
+ *
+ * C and D are kept with their first bit (pc1[0] and pc1[28]) as bit 27,
+ * so the left rotations of FIPS-46 are plain 28-bit rotates.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* permuted choice table (key) */
+static unsigned char pc1[] = {
+	57, 49, 41, 33, 25, 17,  9,
+	 1, 58, 50, 42, 34, 26, 18,
+	10,  2, 59, 51, 43, 35, 27,
+	19, 11,  3, 60, 52, 44, 36,
+
+	63, 55, 47, 39, 31, 23, 15,
+	 7, 62, 54, 46, 38, 30, 22,
+	14,  6, 61, 53, 45, 37, 29,
+	21, 13,  5, 28, 20, 12,  4
+};
+
+/* permuted choice key (table) */
+static unsigned char pc2[] = {
+	14, 17, 11, 24,  1,  5,
+	 3, 28, 15,  6, 21, 10,
+	23, 19, 12,  4, 26,  8,
+	16,  7, 27, 20, 13,  2,
+	41, 52, 31, 37, 47, 55,
+	30, 40, 51, 45, 33, 48,
+	44, 49, 39, 56, 34, 53,
+	46, 42, 50, 36, 29, 32
+};
+
+static uint32_t pc1c[16][16], pc1d[16][16];	/* [key nibble][value] */
+static uint32_t pc2c[7][16][2], pc2d[7][16][2];	/* [C/D nibble][value][word] */
+
+/* Prints rows of n values each, one brace-enclosed row per first index;
+ * with width > 1, every width values within a row are braced again.
+ */
+static void
+print_table(const char *decl, uint32_t *t, int rows, int n, int width)
+{
+	int r, i;
+
+	printf("static const uint32_t %s = {", decl);
+	for (r = 0; r < rows; r++, t += n) {
+		printf("\n    {");
+		for (i = 0; i < n; i++) {
+			if (i % 4 == 0) {
+				printf("\n        ");
+			}
+			if (width > 1 && i % width == 0) {
+				printf("{");
+			}
+			printf(width > 1 && i % width == width - 1 ? "0x%08lx}," : "0x%08lx,",
+			    (unsigned long)t[i]);
+		}
+		printf("\n    },");
+	}
+	printf("\n};\n\n");
+}
+
+int
+main(void)
+{
+	int j, n, v, b, bit, word;
+
+	/* Key bit l (1-based, bit 1 is the MSB of key[0]) lies in nibble
+	 * (l-1)>>2 as bit 3-((l-1)&3).
+	 */
+	for (j = 0; j < 56; j++) {
+		int l = pc1[j] - 1;
+		uint32_t *t = j < 28 ? &pc1c[l >> 2][0] : &pc1d[l >> 2][0];
+		uint32_t mask = 1UL << (27 - j % 28);
+
+		for (v = 0; v < 16; v++) {
+			if (v & (8 >> (l & 3))) {
+				t[v] |= mask;
+			}
+		}
+	}
+
+	/* Subkey bit j goes to ks[j/6] as 040>>(j%6); the even ks bytes are
+	 * packed into word 0 and the odd ones into word 1, MSB first.
+	 */
+	for (j = 0; j < 48; j++) {
+		bit = pc2[j] - 1;		/* 0..27 in C, 28..55 in D */
+		word = (j / 6) & 1;
+		uint32_t mask = (040UL >> (j % 6)) << (24 - 8 * ((j / 6) >> 1));
+
+		b = bit % 28;
+		n = b >> 2;
+		for (v = 0; v < 16; v++) {
+			if (v & (8 >> (b & 3))) {
+				if (bit < 28) {
+					pc2c[n][v][word] |= mask;
+				} else {
+					pc2d[n][v][word] |= mask;
+				}
+			}
+		}
+	}
+
+	printf("/* Generated by genkey.c\n */\n\n");
+	print_table("pc1c[16][16]", &pc1c[0][0], 16, 16, 1);
+	print_table("pc1d[16][16]", &pc1d[0][0], 16, 16, 1);
+	print_table("pc2c[7][16][2]", &pc2c[0][0][0], 7, 16 * 2, 2);
+	print_table("pc2d[7][16][2]", &pc2d[0][0][0], 7, 16 * 2, 2);
+	return 0;
+}
@@ -12,6 +12,8 @@
 #include "DESWrapper.h"
 #include "CrypticStream.h"
 
+#include <unistd.h>
+
 void print_block(const unsigned char* block, int size) {
     for (int x=0; x<size; x++) {
         if (0==(x&7) && x>0) printf("\n");
@@ -26,7 +28,7 @@ int main(int argc, const char * argv[])
     unsigned char* key = (unsigned char*)"abcdefgh";
     const char* filename = "a.out";
     binary_coder::OutputFile file(filename, true);
-    binary_coder::OutputStreamDES desOutput(&file, false);
+    binary_coder::OutputStreamDES desOutput(&file);
     desOutput.setDESKey(key);
     binary_coder::Encoder encoder(&desOutput);
     
@@ -42,7 +44,7 @@ int main(int argc, const char * argv[])
     printf("---------------------------\n");
     
     binary_coder::InputFile inFile(filename, true);
-    binary_coder::InputStreamDES desInput(&inFile, false);
+    binary_coder::InputStreamDES desInput(&inFile);
     desInput.setDESKey(key);
     binary_coder::Decoder decoder(&desInput);
     int8_t b1 = decoder.ReadSignedByte();
@@ -54,6 +56,55 @@ int main(int argc, const char * argv[])
     decoder.ReadString(hello);
     printf("%d\n%d\n%x\n%d\n%s\n\n", b1, s1, bits, i, hello.c_str());
     
+    // Mark, Skip and Reset over a pipe, which cannot seek back: the bytes
+    // back to the mark stay in the decoder, so Reset() reads nothing again.
+    int fds[2];
+    if (pipe(fds) == 0) {
+        uint8_t data[4096];
+        for (int n = 0; n < (int)sizeof(data); n++) {
+            data[n] = (uint8_t)(n * 7 + 3);
+        }
+        ssize_t written = write(fds[1], data, sizeof(data));
+        close(fds[1]);
+        
+        binary_coder::InputFileDescriptor pipeInput(fds[0], true);
+        binary_coder::Decoder pipeDecoder(&pipeInput, 16);
+        pipeDecoder.Mark();
+        uint8_t copy[699];
+        bool same = written == (ssize_t)sizeof(data);
+        same = same && pipeDecoder.ReadBytes(copy, sizeof(copy)) == sizeof(copy);
+        same = same && memcmp(copy, data, sizeof(copy)) == 0;
+        pipeDecoder.Reset();
+        for (int n = 0; n < 1000; n++) {
+            pipeDecoder.Skip(3);
+            same = same && pipeDecoder.ReadUnsignedByte() == data[n * 4 + 3];
+        }
+        pipeDecoder.Reset();
+        same = same && pipeDecoder.ReadUnsignedByte() == data[0];
+        same = same && pipeDecoder.GetLastError() == binary_coder::NoError;
+        
+        // A field that straddles the end of the bytes read through.
+        size_t straddles[] = {14, 30, 4078};
+        for (size_t k = 0; k < sizeof(straddles) / sizeof(straddles[0]) && same; k++) {
+            if (pipe(fds) != 0) {
+                break;
+            }
+            written = write(fds[1], data, sizeof(data));
+            close(fds[1]);
+            binary_coder::InputFileDescriptor straddleInput(fds[0], true);
+            binary_coder::Decoder straddleDecoder(&straddleInput, 16);
+            size_t at = straddles[k];
+            straddleDecoder.Mark();
+            straddleDecoder.Skip(at);
+            uint32_t value = data[at] | data[at + 1] << 8 | data[at + 2] << 16 | (uint32_t)data[at + 3] << 24;
+            same = straddleDecoder.ReadUnsignedInt() == value;
+            straddleDecoder.Reset();
+            same = same && straddleDecoder.ReadUnsignedByte() == data[0];
+            same = same && straddleDecoder.GetLastError() == binary_coder::NoError;
+        }
+        printf("mark/skip/reset over a pipe: %s\n", same ? "ok" : "failed");
+    }
+    
 //    unsigned char* key = (unsigned char*)"abcdefgh";
 //    unsigned char* s2 = (unsigned char*)"Abcdefgh";
     
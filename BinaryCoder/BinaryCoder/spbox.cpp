@@ -0,0 +1,123 @@
+/* Combined S and P boxes for the portable des() and des3(), computed
+ * by the compiler from the FIPS-46 S-boxes and P permutation.
+ *
+ * Each entry holds the P-permuted output of one S-box for one 6-bit
+ * input, rotated 1 bit to the left to match the format of the L and R
+ * halves in desport.c; this avoids one of the left rotates that would
+ * otherwise be required in each round. The table is 2 KB of uint32_t,
+ * half of what it took as unsigned long on LP64 targets.
+ */
+
+#include <stdint.h>
+
+namespace {
+
+/* 32-bit permutation function P used on the output of the S-boxes */
+static constexpr unsigned char p32i[] = {	
+	16,  7, 20, 21,
+	29, 12, 28, 17,
+	 1, 15, 23, 26,
+	 5, 18, 31, 10,
+	 2,  8, 24, 14,
+	32, 27,  3,  9,
+	19, 13, 30,  6,
+	22, 11,  4, 25
+};
+
+/* The (in)famous S-boxes */
+static constexpr unsigned char sbox[8][64] = {
+	/* S1 */
+	14,  4, 13,  1,  2, 15, 11,  8,  3, 10,  6, 12,  5,  9,  0,  7,
+	 0, 15,  7,  4, 14,  2, 13,  1, 10,  6, 12, 11,  9,  5,  3,  8,
+	 4,  1, 14,  8, 13,  6,  2, 11, 15, 12,  9,  7,  3, 10,  5,  0,
+	15, 12,  8,  2,  4,  9,  1,  7,  5, 11,  3, 14, 10,  0,  6, 13,
+
+	/* S2 */
+	15,  1,  8, 14,  6, 11,  3,  4,  9,  7,  2, 13, 12,  0,  5, 10,
+	 3, 13,  4,  7, 15,  2,  8, 14, 12,  0,  1, 10,  6,  9, 11,  5,
+	 0, 14,  7, 11, 10,  4, 13,  1,  5,  8, 12,  6,  9,  3,  2, 15,
+	13,  8, 10,  1,  3, 15,  4,  2, 11,  6,  7, 12,  0,  5, 14,  9,
+
+	/* S3 */
+	10,  0,  9, 14,  6,  3, 15,  5,  1, 13, 12,  7, 11,  4,  2,  8,
+	13,  7,  0,  9,  3,  4,  6, 10,  2,  8,  5, 14, 12, 11, 15,  1,
+	13,  6,  4,  9,  8, 15,  3,  0, 11,  1,  2, 12,  5, 10, 14,  7,
+	 1, 10, 13,  0,  6,  9,  8,  7,  4, 15, 14,  3, 11,  5,  2, 12,
+
+	/* S4 */
+	 7, 13, 14,  3,  0,  6,  9, 10,  1,  2,  8,  5, 11, 12,  4, 15,
+	13,  8, 11,  5,  6, 15,  0,  3,  4,  7,  2, 12,  1, 10, 14,  9,
+	10,  6,  9,  0, 12, 11,  7, 13, 15,  1,  3, 14,  5,  2,  8,  4,
+	 3, 15,  0,  6, 10,  1, 13,  8,  9,  4,  5, 11, 12,  7,  2, 14,
+
+	/* S5 */
+	 2, 12,  4,  1,  7, 10, 11,  6,  8,  5,  3, 15, 13,  0, 14,  9,
+	14, 11,  2, 12,  4,  7, 13,  1,  5,  0, 15, 10,  3,  9,  8,  6,
+	 4,  2,  1, 11, 10, 13,  7,  8, 15,  9, 12,  5,  6,  3,  0, 14,
+	11,  8, 12,  7,  1, 14,  2, 13,  6, 15,  0,  9, 10,  4,  5,  3,
+
+	/* S6 */
+	12,  1, 10, 15,  9,  2,  6,  8,  0, 13,  3,  4, 14,  7,  5, 11,
+	10, 15,  4,  2,  7, 12,  9,  5,  6,  1, 13, 14,  0, 11,  3,  8,
+	 9, 14, 15,  5,  2,  8, 12,  3,  7,  0,  4, 10,  1, 13, 11,  6,
+	 4,  3,  2, 12,  9,  5, 15, 10, 11, 14,  1,  7,  6,  0,  8, 13,
+
+	/* S7 */
+	 4, 11,  2, 14, 15,  0,  8, 13,  3, 12,  9,  7,  5, 10,  6,  1,
+	13,  0, 11,  7,  4,  9,  1, 10, 14,  3,  5, 12,  2, 15,  8,  6,
+	 1,  4, 11, 13, 12,  3,  7, 14, 10, 15,  6,  8,  0,  5,  9,  2,
+	 6, 11, 13,  8,  1,  4, 10,  7,  9,  5,  0, 15, 14,  2,  3, 12,
+
+	/* S8 */
+	13,  2,  8,  4,  6, 15, 11,  1, 10,  9,  3, 14,  5,  0, 12,  7,
+	 1, 15, 13,  8, 10,  3,  7,  4, 12,  5,  6, 11,  0, 14,  9,  2,
+	 7, 11,  4,  1,  9, 12, 14,  2,  0,  6, 10, 13, 15,  3,  5,  8,
+	 2,  1, 14,  7,  4, 10,  8, 13, 15, 12,  9,  0,  3,  5,  6, 11
+};
+
+/* Position of bit p in the output of P (the inverse of p32i) */
+constexpr int
+pbox(int p, int i = 0)
+{
+	return p32i[i]-1 == p ? i : pbox(p, i+1);
+}
+
+/* The row number is formed from the first and last bits of the input,
+ * the column number from the middle 4
+ */
+constexpr int
+rowcol(int i)
+{
+	return (i & 32) | ((i & 1) ? 16 : 0) | ((i >> 1) & 0xf);
+}
+
+constexpr uint32_t
+spbit(int s, int i, int j)
+{
+	return (sbox[s][rowcol(i)] & (8 >> j)) ? (uint32_t)1 << (31 - pbox(4*s + j)) : 0;
+}
+
+constexpr uint32_t
+rotl1(uint32_t x)
+{
+	return (x << 1) | (x >> 31);
+}
+
+constexpr uint32_t
+sp(int s, int i)
+{
+	return rotl1(spbit(s, i, 0) | spbit(s, i, 1) | spbit(s, i, 2) | spbit(s, i, 3));
+}
+
+static_assert(sp(0, 0) == 0x01010400 && sp(7, 63) == 0x10041000,
+	      "Spbox does not match the reference table");
+
+} /* namespace */
+
+#define SP4(s,i)	sp(s,i), sp(s,i+1), sp(s,i+2), sp(s,i+3)
+#define SP16(s,i)	SP4(s,i), SP4(s,i+4), SP4(s,i+8), SP4(s,i+12)
+#define SP64(s)		{ SP16(s,0), SP16(s,16), SP16(s,32), SP16(s,48) }
+
+extern "C" const uint32_t Spbox[8][64] = {
+	SP64(0), SP64(1), SP64(2), SP64(3), SP64(4), SP64(5), SP64(6), SP64(7)
+};